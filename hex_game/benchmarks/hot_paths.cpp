@@ -0,0 +1,367 @@
+/*
+Name: Hex hot path benchmarks
+Author: Alex Stet
+
+Google benchmark suite timing the win detection, rendering (full serialise and per-move redraw), playout, static evaluation, endgame solver and move generation paths
+for board sizes 5, 7, 11, 13, 14 and 19. Reports ns/op, and playouts/s for the playout driven benchmarks.
+Positions are filled from a fixed seed so runs are comparable with each other.
+BM_DefaultBudgetMove times every engine with the budget an interactive game uses by default and checks it
+against the per-move latency target (MOVE_LATENCY_TARGET_MS, 1000 ms up to 19x19).
+
+build (from the hex_game directory):
+    cmake -S . -B build && cmake --build build --target hex_benchmarks
+
+usage:
+    ./build/hex_benchmarks [--benchmark_filter=<regex>] [--benchmark_format=json]
+*/
+
+#include "utils.h"
+#include "hex_board.h"
+#include "player.h"
+#include "playout.h"
+#include "bitboard.h"
+#include "disjoint_set.h"
+#include "resistance.h"
+#include "endgame_solver.h"
+#include "rng.h"
+#include "search_budget.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+// consts
+
+const uint64_t BENCH_SEED = 0x5eed;
+const u_int BENCH_MOVE_PLAYOUTS = 20000;
+
+// structs
+
+// real board holding a reproducible position, moves are delivered through the regular observer path
+struct BenchPosition
+{
+    HexBoardABC *board;
+    HexPlayerABC *players[2];
+    std::pair<u_int, u_int> last_move;
+    VIRTUAL_PIECE last_piece = VIRTUAL_PIECE::NOT_SET;
+
+    // fills `fill` of the cells of a board of the given size, alternating players in a seeded random order
+    BenchPosition(u_int size, double fill)
+        : board(HexBoardFactory::make(size)),
+          players{HexPlayerFactory::make(PLAYER_ID::P1, false), HexPlayerFactory::make(PLAYER_ID::P2, false)}
+    {
+        for (auto player : players)
+            player->attach(board);
+
+        std::vector<u_int> cells(size * size);
+        for (u_int i = 0; i < cells.size(); i++)
+            cells[i] = i;
+        Xoshiro256 rng(BENCH_SEED);
+        fast_shuffle(cells.begin(), cells.end(), rng);
+
+        u_int moves = static_cast<u_int>(fill * cells.size());
+        for (u_int i = 0; i < moves; i++)
+        {
+            last_move = {cells[i] / size, cells[i] % size};
+            last_piece = players[i % 2]->get_id();
+            players[i % 2]->notify(Move{static_cast<uint8_t>(last_move.first), static_cast<uint8_t>(last_move.second), last_piece});
+        }
+    }
+
+    ~BenchPosition()
+    {
+        for (auto player : players)
+        {
+            player->detach(board);
+            delete player;
+        }
+        delete board;
+    }
+};
+
+// Benchmarks
+
+static void BM_PlayerHasWon(benchmark::State &state)
+{
+    BenchPosition position(state.range(0), 1.0);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(position.board->player_has_won(VIRTUAL_PIECE::P1));
+        benchmark::DoNotOptimize(position.board->player_has_won(VIRTUAL_PIECE::P2));
+    }
+}
+
+static void BM_CheckWinOnMove(benchmark::State &state)
+{
+    BenchPosition position(state.range(0), 0.5);
+
+    for (auto _ : state)
+        position.board->check_win_on_move(position.last_piece);
+}
+
+// winner of a filled board settled by a single union-find pass
+static void BM_FilledBoardWinner(benchmark::State &state)
+{
+    BenchPosition position(state.range(0), 1.0);
+    const FlatBoard &board = position.board->get_game_board();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(find_filled_board_winner(board.data(), board.get_size()));
+}
+
+// the same filled board settled by the bitboard flood fill the playouts use, compare with BM_FilledBoardWinner
+static void BM_BitBoardWinner(benchmark::State &state)
+{
+    BenchPosition position(state.range(0), 1.0);
+    HexBitBoard board(position.board->get_game_board());
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(board.find_winner());
+}
+
+// HexBoardReal::serialise is reached through the board's stream operator
+static void BM_Serialise(benchmark::State &state)
+{
+    BenchPosition position(state.range(0), 0.5);
+    std::ostringstream out;
+
+    for (auto _ : state)
+    {
+        out.str(std::string());
+        out << position.board;
+        benchmark::DoNotOptimize(out);
+    }
+}
+
+// serialise into a caller buffer reused between calls, as a spectator stream would
+static void BM_SerialiseIntoBuffer(benchmark::State &state)
+{
+    BenchPosition position(state.range(0), 0.5);
+    HexBoardReal *real_board = static_cast<HexBoardReal *>(position.board);
+    std::string buffer;
+
+    for (auto _ : state)
+    {
+        real_board->serialise(buffer);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * real_board->get_serialised_length());
+}
+
+// one move redrawn by the diff renderer, HexBoardReal::update_board marks the changed glyphs
+static void BM_Redraw(benchmark::State &state)
+{
+    u_int size = state.range(0), cell = size * size;
+    std::unique_ptr<BenchPosition> position;
+    std::ostringstream out;
+    size_t bytes = 0;
+
+    for (auto _ : state)
+    {
+        // a fresh empty board whenever the previous one is full, its full draw is not timed
+        if (cell == size * size)
+        {
+            state.PauseTiming();
+            position.reset(new BenchPosition(size, 0.0));
+            static_cast<HexBoardReal *>(position->board)->draw(out);
+            cell = 0;
+            state.ResumeTiming();
+        }
+
+        position->players[cell % 2]->notify(Move{static_cast<uint8_t>(cell / size), static_cast<uint8_t>(cell % size), position->players[cell % 2]->get_id()});
+        cell++;
+        out.str(std::string());
+        static_cast<HexBoardReal *>(position->board)->redraw(out);
+        bytes += out.tellp();
+    }
+
+    state.counters["bytes/move"] = benchmark::Counter(bytes, benchmark::Counter::kAvgIterations);
+}
+
+static void BM_Playout(benchmark::State &state)
+{
+    FlatBoard empty_board(state.range(0));
+    PlayoutKernel playout_kernel;
+    playout_kernel.prepare(empty_board);
+    Xoshiro256 rng(BENCH_SEED);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(playout_kernel.run(VIRTUAL_PIECE::P1, rng));
+
+    state.counters["playouts/s"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// playouts answering two-bridge intrusions, compare with BM_Playout for the cost of the policy
+static void BM_PlayoutBridge(benchmark::State &state)
+{
+    FlatBoard empty_board(state.range(0));
+    PlayoutKernel playout_kernel(PLAYOUT_POLICY::Bridge);
+    playout_kernel.prepare(empty_board);
+    Xoshiro256 rng(BENCH_SEED);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(playout_kernel.run(VIRTUAL_PIECE::P1, rng));
+
+    state.counters["playouts/s"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// both resistance networks of a position solved from scratch, filled to the given percentage
+// (the empty board has the most nodes)
+static void BM_ResistanceEvaluate(benchmark::State &state)
+{
+    BenchPosition position(state.range(0), state.range(1) / 100.0);
+    ResistanceEvaluator evaluator(state.range(0));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(evaluator.evaluate(position.board->get_game_board(), VIRTUAL_PIECE::P1));
+}
+
+// solve of a position with as many empty cells as the move generators hand to the solver, from an empty table
+static void BM_EndgameSolve(benchmark::State &state)
+{
+    u_int size = state.range(0);
+    BenchPosition position(size, 1.0 - static_cast<double>(SOLVER_MAX_EMPTY_CELLS) / (size * size));
+    VIRTUAL_PIECE to_move = position.last_piece == VIRTUAL_PIECE::P1 ? VIRTUAL_PIECE::P2 : VIRTUAL_PIECE::P1;
+    u_int move, nodes = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::unique_ptr<EndgameSolver> solver(new EndgameSolver(size));
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(solver->solve(position.board->get_game_board(), to_move, move));
+        nodes += solver->get_nodes();
+    }
+
+    state.counters["nodes"] = benchmark::Counter(nodes, benchmark::Counter::kAvgIterations);
+}
+
+static void BM_GenerateMove(benchmark::State &state)
+{
+    BenchPosition position(state.range(0), 0.0);
+    HexBoardVirtual *virtual_board = static_cast<HexBoardVirtual *>(HexBoardFactory::make(position.board));
+    SearchBudget budget;
+    budget.playouts = BENCH_MOVE_PLAYOUTS;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(virtual_board->generate_move(VIRTUAL_PIECE::P1, budget));
+
+    state.counters["playouts/s"] = benchmark::Counter(state.iterations() * BENCH_MOVE_PLAYOUTS, benchmark::Counter::kIsRate);
+    delete virtual_board;
+}
+
+static void BM_GenerateMCTSMove(benchmark::State &state)
+{
+    BenchPosition position(state.range(0), 0.0);
+    HexBoardVirtual *virtual_board = static_cast<HexBoardVirtual *>(HexBoardFactory::make(position.board));
+    SearchBudget budget;
+    budget.playouts = BENCH_MOVE_PLAYOUTS;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(virtual_board->generate_mcts_move(VIRTUAL_PIECE::P1, budget));
+
+    state.counters["playouts/s"] = benchmark::Counter(state.iterations() * BENCH_MOVE_PLAYOUTS, benchmark::Counter::kIsRate);
+    delete virtual_board;
+}
+
+// first move of a game searched with the default budget, the engine is given by the second argument as an AI_ENGINE
+static void BM_DefaultBudgetMove(benchmark::State &state)
+{
+    BenchPosition position(state.range(0), 0.0);
+    HexBoardVirtual *virtual_board = static_cast<HexBoardVirtual *>(HexBoardFactory::make(position.board));
+    AI_ENGINE engine = static_cast<AI_ENGINE>(state.range(1));
+    double worst_ms = 0.0;
+
+    for (auto _ : state)
+    {
+        auto start = std::chrono::steady_clock::now();
+        switch (engine)
+        {
+        case AI_ENGINE::MonteCarlo:
+            benchmark::DoNotOptimize(virtual_board->generate_move(VIRTUAL_PIECE::P1));
+            break;
+        case AI_ENGINE::MCTS:
+            benchmark::DoNotOptimize(virtual_board->generate_mcts_move(VIRTUAL_PIECE::P1));
+            break;
+        case AI_ENGINE::MCTSRootParallel:
+            benchmark::DoNotOptimize(virtual_board->generate_mcts_move(VIRTUAL_PIECE::P1, SearchBudget(), MCTS_MODE::RootParallel));
+            break;
+        case AI_ENGINE::MCTSTreeParallel:
+            benchmark::DoNotOptimize(virtual_board->generate_mcts_move(VIRTUAL_PIECE::P1, SearchBudget(), MCTS_MODE::TreeParallel));
+            break;
+        case AI_ENGINE::Resistance:
+            benchmark::DoNotOptimize(virtual_board->generate_resistance_move(VIRTUAL_PIECE::P1));
+            break;
+        }
+        std::chrono::duration<double, std::milli> move_time = std::chrono::steady_clock::now() - start;
+        worst_ms = std::max(worst_ms, move_time.count());
+    }
+
+    state.counters["worst_ms"] = worst_ms;
+    state.counters["within_target"] = worst_ms <= MOVE_LATENCY_TARGET_MS;
+    delete virtual_board;
+}
+
+// board sizes every benchmark runs on
+static void board_sizes(benchmark::internal::Benchmark *benchmark)
+{
+    for (int size : {5, 7, 11, 13, 14, 19})
+        benchmark->Arg(size);
+}
+
+// every board size empty and filled to 30%
+static void board_sizes_and_fills(benchmark::internal::Benchmark *benchmark)
+{
+    for (int size : {5, 7, 11, 13, 14, 19})
+        for (int fill : {0, 30})
+            benchmark->Args({size, fill});
+}
+
+// board sizes the endgame solver is meant for
+static void solver_sizes(benchmark::internal::Benchmark *benchmark)
+{
+    for (int size : {5, 6, 7})
+        benchmark->Arg(size);
+}
+
+// the tournament board sizes crossed with every engine
+static void tournament_sizes_and_engines(benchmark::internal::Benchmark *benchmark)
+{
+    for (int size : {11, 13, 19})
+        for (AI_ENGINE engine : {AI_ENGINE::MonteCarlo, AI_ENGINE::MCTS, AI_ENGINE::MCTSRootParallel, AI_ENGINE::MCTSTreeParallel, AI_ENGINE::Resistance})
+            benchmark->Args({size, static_cast<int>(engine)});
+}
+
+BENCHMARK(BM_PlayerHasWon)->Apply(board_sizes);
+BENCHMARK(BM_CheckWinOnMove)->Apply(board_sizes);
+BENCHMARK(BM_FilledBoardWinner)->Apply(board_sizes);
+BENCHMARK(BM_BitBoardWinner)->Apply(board_sizes);
+BENCHMARK(BM_Serialise)->Apply(board_sizes);
+BENCHMARK(BM_SerialiseIntoBuffer)->Apply(board_sizes);
+BENCHMARK(BM_Redraw)->Apply(board_sizes);
+BENCHMARK(BM_Playout)->Apply(board_sizes);
+BENCHMARK(BM_PlayoutBridge)->Apply(board_sizes);
+BENCHMARK(BM_ResistanceEvaluate)->Apply(board_sizes_and_fills);
+BENCHMARK(BM_EndgameSolve)->Apply(solver_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GenerateMove)->Apply(board_sizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_GenerateMCTSMove)->Apply(board_sizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_DefaultBudgetMove)->Apply(tournament_sizes_and_engines)->Unit(benchmark::kMillisecond)->UseRealTime()->Iterations(3);
+
+// BENCHMARK_MAIN with the compiled in bitboard SIMD backend added to the run context
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::AddCustomContext("bitboard_simd", bitboard_simd_backend());
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+Name: Parallel MCTS scaling benchmark
+Author: Alex Stet
+
+Reports playouts per second of the root parallel and tree parallel searches
+from an empty board for 1 to N worker threads (N = hardware threads).
+
+build (from the hex_game directory):
+    cmake -S . -B build && cmake --build build --target mcts_scaling
+
+usage:
+    ./mcts_scaling [board size = 11] [playouts per search = 200000]
+*/
+
+#include "utils.h"
+#include "flat_board.h"
+#include "parallel_mcts.h"
+#include "thread_pool.h"
+#include "zobrist.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// times a single search and returns the achieved playouts per second
+double playouts_per_second(ParallelMCTSEngine &engine, const FlatBoard &board, MCTS_MODE mode, u_int playouts)
+{
+    SearchBudget budget;
+    budget.playouts = playouts;
+
+    auto start = std::chrono::steady_clock::now();
+    engine.search(board, zobrist_hash(board), VIRTUAL_PIECE::P1, mode, budget);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return playouts / elapsed.count();
+}
+
+int main(int argc, char **argv)
+{
+    u_int board_size = (argc > 1) ? std::atoi(argv[1]) : 11;
+    u_int playouts = (argc > 2) ? std::atoi(argv[2]) : 200000;
+    u_int max_threads = ThreadPool::default_size();
+
+    std::vector<u_int> thread_counts;
+    for (u_int threads = 1; threads < max_threads; threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(max_threads);
+
+    const FlatBoard board(board_size);
+    double root_baseline = 0.0, tree_baseline = 0.0;
+
+    std::cout << "board " << board_size << "x" << board_size << ", " << playouts << " playouts per search\n";
+    std::cout << std::setw(8) << "threads" << std::setw(16) << "root playouts/s" << std::setw(10) << "speedup"
+              << std::setw(16) << "tree playouts/s" << std::setw(10) << "speedup" << '\n';
+
+    for (u_int threads : thread_counts)
+    {
+        ThreadPool pool(threads);
+        ParallelMCTSEngine engine(pool);
+
+        double root_rate = playouts_per_second(engine, board, MCTS_MODE::RootParallel, playouts);
+        double tree_rate = playouts_per_second(engine, board, MCTS_MODE::TreeParallel, playouts);
+        if (threads == 1)
+        {
+            root_baseline = root_rate;
+            tree_baseline = tree_rate;
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(8) << threads
+                  << std::setw(16) << std::setprecision(0) << root_rate << std::setw(10) << std::setprecision(2) << root_rate / root_baseline
+                  << std::setw(16) << std::setprecision(0) << tree_rate << std::setw(10) << std::setprecision(2) << tree_rate / tree_baseline << '\n';
+    }
+
+    return 0;
+}
@@ -9,7 +9,11 @@ Note:
     macOS, linux -> any version
 
 gcc compile instructions:
-    g++ -pthread -o hex -I ./source/ main.cpp source/*cpp -Wno-varargs
+    g++ -pthread -o hex -I ./source/ main.cpp source/*cpp
+    (add -O2 -march=native to enable the AVX2 bitboard playouts, SSE2 is used otherwise)
+
+cmake build instructions (game, tournament runner and benchmarks):
+    cmake -S . -B build && cmake --build build
 */
 
 #include "utils.h"
@@ -20,18 +24,19 @@ gcc compile instructions:
 #include <unordered_map>
 #include <map>
 
-// main game loop
+// main game loop, the board is drawn once and only the cells changed by each move are redrawn
 void game_loop(const std::unordered_map<bool, HexPlayerABC *> &players, std::map<PlayerType, HexBoardABC *&> &boards)
 {
+    HexBoardReal *real_board = static_cast<HexBoardReal *>(boards.at(PlayerType::Real));
+    real_board->draw(std::cout);
+
     bool player_switch = true;
-    while (!boards.at(PlayerType::Real)->get_win_state())
+    while (!real_board->get_win_state())
     {
-        std::cout << boards.at(PlayerType::Real);
         players.at(player_switch)->make_move(boards.at(players.at(player_switch)->get_player_type()));
         player_switch = !player_switch;
-        clear_lines(3 * boards.at(PlayerType::Real)->get_size());
+        real_board->redraw(std::cout);
     }
-    std::cout << boards.at(PlayerType::Real);
     print_win_state(players.at(!player_switch)->get_id());
 }
 
@@ -45,10 +50,15 @@ int main()
     clear_lines(10);
 
     bool ai_switch, colour_switch;
-    query_player_params(ai_switch, colour_switch);
+    AI_ENGINE engine = AI_ENGINE::MonteCarlo;
+    query_player_params(ai_switch, colour_switch, engine);
+
+    SearchBudget budget;
+    if (ai_switch && engine != AI_ENGINE::Resistance)
+        query_search_params(budget.time_ms);
 
     HexPlayerABC *p1, *p2;
-    HexPlayerFactory::init_players(p1, p2, ai_switch, colour_switch);
+    HexPlayerFactory::init_players(p1, p2, ai_switch, colour_switch, engine, budget);
     const std::unordered_map<bool, HexPlayerABC *> players =
         {
             {true, p1},
@@ -67,13 +77,25 @@ int main()
             {PlayerType::Virtual, virtual_board},
         };
 
-    p1->attach(boards.at(p1->get_player_type()));
-    p2->attach(boards.at(p2->get_player_type()));
+    // every board follows every move, so each keeps its own groups in step
+    // and the ai's virtual board can reuse its trees and ponder on the human's time
+    p1->attach(boards.at(PlayerType::Real));
+    p2->attach(boards.at(PlayerType::Real));
+    if (ai_switch)
+    {
+        p1->attach(boards.at(PlayerType::Virtual));
+        p2->attach(boards.at(PlayerType::Virtual));
+    }
 
     game_loop(players, boards);
 
-    p1->detach(boards.at(p1->get_player_type()));
-    p2->detach(boards.at(p2->get_player_type()));
+    if (ai_switch)
+    {
+        p1->detach(boards.at(PlayerType::Virtual));
+        p2->detach(boards.at(PlayerType::Virtual));
+    }
+    p1->detach(boards.at(PlayerType::Real));
+    p2->detach(boards.at(PlayerType::Real));
 
     delete p1;
     delete p2;
@@ -0,0 +1,188 @@
+#include "bitboard.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// lane packs, a group of consecutive rows processed together by the flood fill
+// (AVX2 and SSE2 when the compiler targets them, a single row otherwise)
+
+#if defined(__AVX2__)
+struct LanePack
+{
+    static const u_int WIDTH = 8;
+    __m256i v;
+
+    static LanePack load(const uint32_t *lanes) { return {_mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes))}; }
+    static LanePack zero() { return {_mm256_setzero_si256()}; }
+    void store(uint32_t *lanes) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), v); }
+    bool any() { return !_mm256_testz_si256(v, v); }
+
+    LanePack operator|(LanePack other) { return {_mm256_or_si256(v, other.v)}; }
+    LanePack operator&(LanePack other) { return {_mm256_and_si256(v, other.v)}; }
+    LanePack operator^(LanePack other) { return {_mm256_xor_si256(v, other.v)}; }
+    template <int N>
+    LanePack shl() { return {_mm256_slli_epi32(v, N)}; }
+    template <int N>
+    LanePack shr() { return {_mm256_srli_epi32(v, N)}; }
+};
+#elif defined(__SSE2__)
+struct LanePack
+{
+    static const u_int WIDTH = 4;
+    __m128i v;
+
+    static LanePack load(const uint32_t *lanes) { return {_mm_loadu_si128(reinterpret_cast<const __m128i *>(lanes))}; }
+    static LanePack zero() { return {_mm_setzero_si128()}; }
+    void store(uint32_t *lanes) { _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), v); }
+    bool any() { return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) != 0xFFFF; }
+
+    LanePack operator|(LanePack other) { return {_mm_or_si128(v, other.v)}; }
+    LanePack operator&(LanePack other) { return {_mm_and_si128(v, other.v)}; }
+    LanePack operator^(LanePack other) { return {_mm_xor_si128(v, other.v)}; }
+    template <int N>
+    LanePack shl() { return {_mm_slli_epi32(v, N)}; }
+    template <int N>
+    LanePack shr() { return {_mm_srli_epi32(v, N)}; }
+};
+#else
+struct LanePack
+{
+    static const u_int WIDTH = 1;
+    uint32_t v;
+
+    static LanePack load(const uint32_t *lanes) { return {*lanes}; }
+    static LanePack zero() { return {0}; }
+    void store(uint32_t *lanes) { *lanes = v; }
+    bool any() { return v != 0; }
+
+    LanePack operator|(LanePack other) { return {v | other.v}; }
+    LanePack operator&(LanePack other) { return {v & other.v}; }
+    LanePack operator^(LanePack other) { return {v ^ other.v}; }
+    template <int N>
+    LanePack shl() { return {v << N}; }
+    template <int N>
+    LanePack shr() { return {v >> N}; }
+};
+#endif
+
+// returns the name of the SIMD backend compiled in
+const char *bitboard_simd_backend()
+{
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+// extends the reached cells along their rows through runs of own stones (Kogge-Stone occluded fill)
+static LanePack fill_rows(LanePack reach, LanePack own)
+{
+    LanePack left = reach, right = reach;
+    LanePack left_pro = own, right_pro = own;
+
+    left = left | (left_pro & left.shl<1>());
+    left_pro = left_pro & left_pro.shl<1>();
+    left = left | (left_pro & left.shl<2>());
+    left_pro = left_pro & left_pro.shl<2>();
+    left = left | (left_pro & left.shl<4>());
+    left_pro = left_pro & left_pro.shl<4>();
+    left = left | (left_pro & left.shl<8>());
+    left_pro = left_pro & left_pro.shl<8>();
+    left = left | (left_pro & left.shl<16>());
+
+    right = right | (right_pro & right.shr<1>());
+    right_pro = right_pro & right_pro.shr<1>();
+    right = right | (right_pro & right.shr<2>());
+    right_pro = right_pro & right_pro.shr<2>();
+    right = right | (right_pro & right.shr<4>());
+    right_pro = right_pro & right_pro.shr<4>();
+    right = right | (right_pro & right.shr<8>());
+    right_pro = right_pro & right_pro.shr<8>();
+    right = right | (right_pro & right.shr<16>());
+
+    return left | right;
+}
+
+/*
+ * Flood fills the given player's stones from their first edge and reports if the fill touches the second one.
+ * Each sweep grows the reached set by one row up and down (UP_LEFT/UP_RIGHT and DOWN_LEFT/DOWN_RIGHT
+ * are lane shifts of the neighbouring rows) and along whole runs within each row, rows are updated
+ * in place so a sweep usually carries the fill across several rows at once.
+ */
+static bool flood_connects(const BitLanes &own, u_int size, bool west_east)
+{
+    alignas(32) BitLanes reach{};
+    const u_int last_row = BITBOARD_FIRST_ROW + size - 1;
+    const uint32_t last_col = uint32_t(1) << (size - 1);
+
+    if (west_east)
+        for (u_int i = BITBOARD_FIRST_ROW; i <= last_row; i++)
+            reach[i] = own[i] & 1;
+    else
+        reach[BITBOARD_FIRST_ROW] = own[BITBOARD_FIRST_ROW];
+
+    while (true)
+    {
+        LanePack delta = LanePack::zero();
+        for (u_int i = BITBOARD_FIRST_ROW; i <= last_row; i += LanePack::WIDTH)
+        {
+            LanePack row = LanePack::load(&reach[i]);
+            LanePack up = LanePack::load(&reach[i - 1]);
+            LanePack down = LanePack::load(&reach[i + 1]);
+            LanePack own_row = LanePack::load(&own[i]);
+
+            LanePack grown = own_row & (row | up | up.shr<1>() | down | down.shl<1>());
+            grown = fill_rows(grown, own_row);
+
+            delta = delta | (grown ^ row);
+            grown.store(&reach[i]);
+        }
+
+        if (west_east)
+        {
+            uint32_t touched = 0;
+            for (u_int i = BITBOARD_FIRST_ROW; i <= last_row; i++)
+                touched |= reach[i];
+            if (touched & last_col)
+                return true;
+        }
+        else if (reach[last_row])
+            return true;
+
+        if (!delta.any())
+            return false;
+    }
+}
+
+// builds the bitboard of a flat board
+HexBitBoard::HexBitBoard(const FlatBoard &board) : size(board.get_size()), p1_stones(), p2_stones()
+{
+    for (u_int i = 0; i < size; i++)
+        for (u_int j = 0; j < size; j++)
+            if (board(i, j) != VIRTUAL_PIECE::NOT_SET)
+                set(i, j, board(i, j));
+}
+
+// checks if the given player connected their two edges
+bool HexBitBoard::player_connected(VIRTUAL_PIECE p_id)
+{
+    if (p_id == VIRTUAL_PIECE::P1)
+        return flood_connects(p1_stones, size, true);
+    return flood_connects(p2_stones, size, false);
+}
+
+// returns the player who connected their edges, NOT_SET if neither did
+VIRTUAL_PIECE HexBitBoard::find_winner()
+{
+    if (player_connected(VIRTUAL_PIECE::P1))
+        return VIRTUAL_PIECE::P1;
+    if (player_connected(VIRTUAL_PIECE::P2))
+        return VIRTUAL_PIECE::P2;
+    return VIRTUAL_PIECE::NOT_SET;
+}
@@ -0,0 +1,53 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "utils.h"
+#include "flat_board.h"
+
+#include <array>
+#include <cstdint>
+
+#define VIRTUAL_PIECE ID_ENUM
+
+// consts
+
+// one 32 bit lane per row plus a zeroed guard lane above the first row and padding
+// below the last one, so every SIMD chunk can read its neighbouring rows unchecked
+const u_int BITBOARD_LANES = 32;
+const u_int BITBOARD_FIRST_ROW = 1;
+
+static_assert(MAX_BOARD_SIZE < 32, "board rows must fit in a 32 bit lane");
+static_assert(BITBOARD_FIRST_ROW + MAX_BOARD_SIZE + 8 <= BITBOARD_LANES, "lanes must cover the last SIMD chunk and its guard row");
+
+// typedefs
+
+typedef std::array<uint32_t, BITBOARD_LANES> BitLanes;
+
+// Hex board stored as one bit per cell per player, row i column j is bit j of lane i + BITBOARD_FIRST_ROW
+class HexBitBoard
+{
+private:
+    u_int size;
+    alignas(32) BitLanes p1_stones;
+    alignas(32) BitLanes p2_stones;
+
+public:
+    HexBitBoard(u_int size) : size(size), p1_stones(), p2_stones() {}
+    HexBitBoard(const FlatBoard &);
+
+    u_int get_size() { return size; }
+
+    void set(u_int row, u_int col, VIRTUAL_PIECE p_id)
+    {
+        (p_id == VIRTUAL_PIECE::P1 ? p1_stones : p2_stones)[row + BITBOARD_FIRST_ROW] |= uint32_t(1) << col;
+    }
+
+    bool player_connected(VIRTUAL_PIECE);
+    VIRTUAL_PIECE find_winner();
+};
+
+// Function definitions
+
+const char *bitboard_simd_backend();
+
+#endif
@@ -0,0 +1,239 @@
+#include "board_renderer.h"
+
+#include <algorithm>
+#include <cstring>
+
+// consts
+
+// every colour code has the same length, so a glyph can be recoloured in place in the serialised board
+constexpr size_t COLOUR_LENGTH = std::char_traits<char>::length(WHITE);
+static_assert(std::char_traits<char>::length(BLUE) == COLOUR_LENGTH && std::char_traits<char>::length(RED) == COLOUR_LENGTH,
+              "colour codes must share one length");
+// terminal offset of the separator lying towards each neighbour, relative to the cell, indexed by NEIGHBOUR
+constexpr std::array<std::pair<int, int>, NEIGHBOUR_COUNT> SEPARATOR_OFFSET = {{{-1, -1}, {-1, 1}, {0, 2}, {0, -2}, {1, 1}, {1, -1}}};
+
+// terminal line and column of a board cell
+static std::pair<u_int, u_int> cell_position(u_int row, u_int col)
+{
+    return {1 + 2 * row, 3 + 2 * row + 4 * col};
+}
+
+// lays out the empty board, the grid is never resized afterwards
+BoardRenderer::BoardRenderer(u_int size)
+    : size(size), width(6 * size + make_string_idx_from_int_idx(size ? size - 1 : 0).size()), height(2 * size + 2),
+      grid(width * height, RenderGlyph{" ", VIRTUAL_PIECE::NOT_SET, GLYPH_STYLE::Plain, false}), line_end(height, 0),
+      serialised_offset(width * height, 0)
+{
+    // a glyph is listed at most once, so the list never outgrows the grid even if nothing is ever drawn
+    dirty.reserve(grid.size());
+    frame.reserve(width * height * 8);
+    layout();
+    build_serialised();
+}
+
+// writes a glyph into the grid without marking it for redraw
+void BoardRenderer::put(u_int line, u_int col, const char *text, VIRTUAL_PIECE colour, GLYPH_STYLE style)
+{
+    RenderGlyph &glyph = at(line, col);
+    size_t length = std::strlen(text);
+    if (length >= sizeof(glyph.text))
+        throw UNDEFINED_BEHAVIOUR_ERROR;
+    std::memcpy(glyph.text, text, length + 1);
+    glyph.colour = colour;
+    glyph.style = style;
+}
+
+// writes a glyph into the grid and the serialised board and marks it for the next redraw if it changed
+// (only pieces and separators change, they keep the length of their text)
+void BoardRenderer::update(u_int line, u_int col, const char *text, VIRTUAL_PIECE colour)
+{
+    RenderGlyph &glyph = at(line, col);
+    if (glyph.colour == colour && std::strcmp(glyph.text, text) == 0)
+        return;
+    if (glyph.style != GLYPH_STYLE::Coloured || std::strlen(text) != std::strlen(glyph.text))
+        throw UNDEFINED_BEHAVIOUR_ERROR;
+
+    put(line, col, text, colour, glyph.style);
+    char *out = &serialised[serialised_offset[line * width + col]];
+    out = std::copy_n(RENDER_COLOUR[static_cast<u_int>(colour)], COLOUR_LENGTH, out);
+    std::copy_n(glyph.text, std::strlen(glyph.text), out);
+    if (glyph.dirty)
+        return;
+    glyph.dirty = true;
+    dirty.push_back(line * width + col);
+}
+
+/*
+ * Places the walls, labels, empty cells and separators:
+ * row i is on line 2i + 1 shifted right by 2i columns, cells are 4 columns apart with a separator in between,
+ * and the separators to the next row sit on the line below.
+ * Every line ends at its last glyph, except the column labels which keep the padding after the last one.
+ */
+void BoardRenderer::layout()
+{
+    const char empty_piece[2] = {RENDER_PIECE_GLYPH[static_cast<u_int>(VIRTUAL_PIECE::NOT_SET)], '\0'};
+
+    for (u_int col = 2; col < 4 * size; col++)
+        put(0, col, "_", VIRTUAL_PIECE::P2, GLYPH_STYLE::Wall);
+
+    for (u_int i = 0; i < size; i++)
+    {
+        std::string row_label = std::to_string(i + 1);
+        for (u_int k = 0; k < row_label.size(); k++)
+            put(1 + 2 * i, k, std::string(1, row_label[k]).c_str(), VIRTUAL_PIECE::NOT_SET, GLYPH_STYLE::Plain);
+
+        put(1 + 2 * i, 2 + 2 * i, "\\", VIRTUAL_PIECE::P1);
+        put(1 + 2 * i, 2 * i + 4 * size, "\\", VIRTUAL_PIECE::P1);
+        if (i < size - 1)
+        {
+            put(2 + 2 * i, 3 + 2 * i, "\\", VIRTUAL_PIECE::P1);
+            put(2 + 2 * i, 2 * i + 4 * size + 1, "\\", VIRTUAL_PIECE::P1);
+        }
+
+        for (u_int j = 0; j < size; j++)
+        {
+            std::pair<u_int, u_int> position = cell_position(i, j);
+            put(position.first, position.second, empty_piece, VIRTUAL_PIECE::NOT_SET);
+            for (int direction : {static_cast<int>(NEIGHBOUR::ROW_RIGHT), static_cast<int>(NEIGHBOUR::DOWN_RIGHT), static_cast<int>(NEIGHBOUR::DOWN_LEFT)})
+            {
+                int row = i + NEIGHBOUR_OFFSET[direction].first, col = j + NEIGHBOUR_OFFSET[direction].second;
+                if (row < static_cast<int>(size) && col >= 0 && col < static_cast<int>(size))
+                    put(position.first + SEPARATOR_OFFSET[direction].first, position.second + SEPARATOR_OFFSET[direction].second,
+                        RENDER_SEPARATOR_GLYPH[direction], VIRTUAL_PIECE::NOT_SET);
+            }
+        }
+    }
+
+    for (u_int col = 2 * size + 1; col < 6 * size - 1; col++)
+        put(2 * size, col, "¯", VIRTUAL_PIECE::P2, GLYPH_STYLE::Wall);
+
+    for (u_int j = 0; j < size; j++)
+    {
+        std::string col_label = make_string_idx_from_int_idx(j);
+        for (u_int k = 0; k < col_label.size(); k++)
+            put(2 * size + 1, 2 * size + 1 + 4 * j + k, std::string(1, col_label[k]).c_str(), VIRTUAL_PIECE::NOT_SET, GLYPH_STYLE::Plain);
+    }
+
+    for (u_int line = 0; line < height; line++)
+        for (u_int col = 0; col < width; col++)
+            if (at(line, col).text[0] != ' ')
+                line_end[line] = col + 1;
+    line_end[2 * size + 1] = width;
+}
+
+/*
+ * Writes the grid out as plain text, remembering where each glyph starts.
+ * Coloured glyphs are wrapped in their colour and WHITE, a run of wall glyphs shares one colour and WHITE
+ * and blanks and labels are written as is.
+ */
+void BoardRenderer::build_serialised()
+{
+    serialised.clear();
+    for (u_int line = 0; line < height; line++)
+    {
+        for (u_int col = 0; col < line_end[line]; col++)
+        {
+            const RenderGlyph &glyph = at(line, col);
+            bool opens = glyph.style == GLYPH_STYLE::Coloured || (glyph.style == GLYPH_STYLE::Wall && (col == 0 || at(line, col - 1).style != GLYPH_STYLE::Wall));
+            bool closes = glyph.style == GLYPH_STYLE::Coloured || (glyph.style == GLYPH_STYLE::Wall && (col + 1 == line_end[line] || at(line, col + 1).style != GLYPH_STYLE::Wall));
+
+            serialised_offset[line * width + col] = serialised.size();
+            if (opens)
+                serialised += RENDER_COLOUR[static_cast<u_int>(glyph.colour)];
+            serialised += glyph.text;
+            if (closes)
+                serialised += WHITE;
+        }
+        serialised += '\n';
+    }
+}
+
+// updates a played cell and the separators to its six neighbours, a separator takes the colour of two equal pieces
+void BoardRenderer::set_cell(const FlatBoard &board, u_int idx)
+{
+    std::pair<u_int, u_int> coords = board.coords(idx);
+    std::pair<u_int, u_int> position = cell_position(coords.first, coords.second);
+    VIRTUAL_PIECE piece = board[idx];
+    const char piece_glyph[2] = {RENDER_PIECE_GLYPH[static_cast<u_int>(piece)], '\0'};
+
+    update(position.first, position.second, piece_glyph, piece);
+    for (int direction = 0; direction < NEIGHBOUR_COUNT; direction++)
+    {
+        int16_t neighbour = board.neighbour(idx, static_cast<NEIGHBOUR>(direction));
+        if (neighbour == NO_NEIGHBOUR)
+            continue;
+        update(position.first + SEPARATOR_OFFSET[direction].first, position.second + SEPARATOR_OFFSET[direction].second,
+               RENDER_SEPARATOR_GLYPH[direction], board[neighbour] == piece ? piece : VIRTUAL_PIECE::NOT_SET);
+    }
+}
+
+// appends a glyph to the frame, switching colour only when it differs from the last one written
+void BoardRenderer::append_glyph(const RenderGlyph &glyph, VIRTUAL_PIECE &colour)
+{
+    if (glyph.colour != colour && glyph.text[0] != ' ')
+    {
+        colour = glyph.colour;
+        frame += RENDER_COLOUR[static_cast<u_int>(colour)];
+    }
+    frame += glyph.text;
+}
+
+// forgets the glyphs changed since the last draw
+void BoardRenderer::clear_dirty()
+{
+    for (u_int position : dirty)
+        grid[position].dirty = false;
+    dirty.clear();
+}
+
+// clears the screen and draws the whole board from the top left corner, the cursor is left on the line below it
+void BoardRenderer::draw(std::ostream &out)
+{
+    VIRTUAL_PIECE colour = VIRTUAL_PIECE::NOT_SET;
+    frame.clear();
+    frame += CURSOR_HOME ERASE_SCREEN WHITE;
+
+    for (u_int line = 0; line < height; line++)
+    {
+        for (u_int col = 0; col < line_end[line]; col++)
+            append_glyph(at(line, col), colour);
+        frame += '\n';
+    }
+    frame += WHITE;
+
+    clear_dirty();
+    out.write(frame.data(), frame.size());
+    out.flush();
+}
+
+// writes the glyphs changed since the last draw and clears everything below the board
+void BoardRenderer::redraw(std::ostream &out)
+{
+    VIRTUAL_PIECE colour = VIRTUAL_PIECE::NOT_SET;
+    frame.clear();
+    frame += WHITE;
+
+    // glyphs next to each other on a line are written in one run without moving the cursor in between
+    std::sort(dirty.begin(), dirty.end());
+    u_int cursor = width * height;
+    for (u_int position : dirty)
+    {
+        if (position != cursor)
+            frame += "\x1b[" + std::to_string(position / width + 1) + ";" + std::to_string(position % width + 1) + "H";
+        append_glyph(grid[position], colour);
+        cursor = position + 1;
+    }
+    frame += "\x1b[" + std::to_string(height + 1) + ";1H" ERASE_TO_SCREEN_END WHITE;
+
+    clear_dirty();
+    out.write(frame.data(), frame.size());
+    out.flush();
+}
+
+// copies the serialised board into the given buffer, replacing its contents
+// a buffer reused between calls (i.e. by a spectator stream) is sized once and never reallocated
+void BoardRenderer::serialise(std::string &buffer) const
+{
+    buffer.resize(serialised.size());
+    std::copy(serialised.begin(), serialised.end(), buffer.begin());
+}
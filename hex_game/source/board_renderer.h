@@ -0,0 +1,84 @@
+#ifndef BOARD_RENDERER_H
+#define BOARD_RENDERER_H
+
+#include "utils.h"
+#include "flat_board.h"
+
+#include <array>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+#define VIRTUAL_PIECE ID_ENUM
+
+// consts
+
+// glyph and colour of each piece indexed by VIRTUAL_PIECE, matching PLAYER_PIECE and PLAYER_COLOUR
+constexpr std::array<char, 3> RENDER_PIECE_GLYPH = {'.', 'X', 'O'};
+constexpr std::array<const char *, 3> RENDER_COLOUR = {WHITE, BLUE, RED};
+// glyph of the separator lying towards each neighbour of a cell, indexed by NEIGHBOUR
+constexpr std::array<const char *, NEIGHBOUR_COUNT> RENDER_SEPARATOR_GLYPH = {"\\", "/", "-", "-", "\\", "/"};
+
+// enums
+
+// how a glyph is written out by BoardRenderer::serialise
+enum class GLYPH_STYLE
+{
+    Plain,    // as is: blanks and labels
+    Coloured, // wrapped in its colour and WHITE: pieces, separators and side walls
+    Wall,     // top and bottom walls, a run of them shares one colour and WHITE
+};
+
+// structs
+
+// one terminal column of the rendered board, `text` holds a single utf-8 character and its terminator
+struct RenderGlyph
+{
+    char text[5];
+    VIRTUAL_PIECE colour;
+    GLYPH_STYLE style;
+    bool dirty; // listed in BoardRenderer::dirty
+};
+
+/*
+ * Terminal renderer of a real board.
+ * The board is laid out once into a grid of glyphs, one per terminal column, drawn in full by draw().
+ * Afterwards set_cell() updates a played cell and its six separators and redraw() writes only the glyphs that
+ * changed, addressed with cursor positioning, so a move costs a constant number of bytes whatever the board size.
+ * The board is drawn from the top left corner of the screen and the area below it is free for prompts.
+ * The same grid is the one layout of the board: it is also kept as plain text with every glyph self-coloured,
+ * which serialise() copies out for the board's stream operator.
+ */
+class BoardRenderer
+{
+private:
+    u_int size;
+    u_int width;
+    u_int height;
+    std::vector<RenderGlyph> grid;
+    std::vector<u_int> line_end;          // columns written out of each line, trailing blanks excluded
+    std::string serialised;               // the grid as plain text, patched by every update
+    std::vector<u_int> serialised_offset; // position of each glyph in `serialised`
+    std::vector<u_int> dirty; // grid positions changed since the last draw, each listed once
+    std::string frame;        // output buffer reused by every draw
+
+    RenderGlyph &at(u_int line, u_int col) { return grid[line * width + col]; }
+    void put(u_int, u_int, const char *, VIRTUAL_PIECE, GLYPH_STYLE = GLYPH_STYLE::Coloured);
+    void update(u_int, u_int, const char *, VIRTUAL_PIECE);
+    void append_glyph(const RenderGlyph &, VIRTUAL_PIECE &);
+    void clear_dirty();
+    void layout();
+    void build_serialised();
+
+public:
+    BoardRenderer(u_int);
+
+    void set_cell(const FlatBoard &, u_int);
+    void draw(std::ostream &);
+    void redraw(std::ostream &);
+    size_t get_serialised_length() const { return serialised.size(); }
+    void serialise(std::string &) const;
+};
+
+#endif
@@ -0,0 +1,138 @@
+#include "disjoint_set.h"
+
+// makes every cell and edge node its own singleton set
+void HexDisjointSet::reset(u_int board_size)
+{
+    size = board_size;
+    edges = &EdgeTable::for_size(size);
+    u_int node_count = size * size + EDGE_NODE_COUNT;
+    for (u_int i = 0; i < node_count; i++)
+    {
+        parent[i] = i;
+        rank[i] = 0;
+        cell_count[i] = i < size * size;
+        edge_mask[i] = i < size * size ? 0 : 1 << (i - size * size);
+    }
+}
+
+// returns the representative of the node's set, halving the path on the way up
+u_int HexDisjointSet::find(u_int node)
+{
+    while (parent[node] != node)
+    {
+        parent[node] = parent[parent[node]];
+        node = parent[node];
+    }
+    return node;
+}
+
+// merges the sets containing the two nodes (union by rank)
+void HexDisjointSet::unite(u_int a, u_int b)
+{
+    a = find(a);
+    b = find(b);
+    if (a == b)
+        return;
+
+    if (rank[a] < rank[b])
+        std::swap(a, b);
+    parent[b] = a;
+    cell_count[a] += cell_count[b];
+    edge_mask[a] |= edge_mask[b];
+    if (rank[a] == rank[b])
+        rank[a] += 1;
+}
+
+// returns the EDGE_NODE bits of the player edges a cell holding the given piece lies on
+uint8_t HexDisjointSet::edges_of(u_int idx, VIRTUAL_PIECE piece)
+{
+    EDGE_NODE first = piece == VIRTUAL_PIECE::P1 ? EDGE_NODE::P1_FIRST : EDGE_NODE::P2_FIRST;
+    return (*edges)(idx, piece) << static_cast<u_int>(first);
+}
+
+// joins a cell holding the given piece with the virtual nodes of the player edges it lies on
+void HexDisjointSet::unite_edges(u_int idx, VIRTUAL_PIECE piece)
+{
+    uint8_t edges = edges_of(idx, piece);
+    for (u_int edge = 0; edge < EDGE_NODE_COUNT; edge++)
+        if (edges & (1 << edge))
+            unite(idx, edge_node(static_cast<EDGE_NODE>(edge)));
+}
+
+/*
+ * Adds the stone just placed on the given cell of a flat row-major cell array,
+ * joining it with its same coloured neighbours (all six directions) and keeping the forest in step with a board.
+ * Stones are never joined with the edge nodes here so groups stay true groups of stones, the edges a group
+ * touches are tracked in its mask instead and the player's two edge nodes are only joined once one group
+ * touches both of them, so player_connected stays a root comparison.
+ */
+void HexDisjointSet::add_stone(const VIRTUAL_PIECE *cells, u_int idx)
+{
+    u_int i = idx / size, j = idx % size;
+    VIRTUAL_PIECE piece = cells[idx];
+
+    if (j > 0 && cells[idx - 1] == piece)
+        unite(idx, idx - 1);
+    if (j < size - 1 && cells[idx + 1] == piece)
+        unite(idx, idx + 1);
+    if (i > 0 && cells[idx - size] == piece)
+        unite(idx, idx - size);
+    if (i > 0 && j < size - 1 && cells[idx - size + 1] == piece)
+        unite(idx, idx - size + 1);
+    if (i < size - 1 && cells[idx + size] == piece)
+        unite(idx, idx + size);
+    if (i < size - 1 && j > 0 && cells[idx + size - 1] == piece)
+        unite(idx, idx + size - 1);
+
+    u_int root = find(idx);
+    edge_mask[root] |= edges_of(idx, piece);
+
+    EDGE_NODE first = piece == VIRTUAL_PIECE::P1 ? EDGE_NODE::P1_FIRST : EDGE_NODE::P2_FIRST;
+    EDGE_NODE second = piece == VIRTUAL_PIECE::P1 ? EDGE_NODE::P1_SECOND : EDGE_NODE::P2_SECOND;
+    if (group_touches(root, first) && group_touches(root, second))
+        unite(edge_node(first), edge_node(second));
+}
+
+// checks if the given player's two edges ended up in the same set
+bool HexDisjointSet::player_connected(VIRTUAL_PIECE p_id)
+{
+    if (p_id == VIRTUAL_PIECE::P1)
+        return connected(edge_node(EDGE_NODE::P1_FIRST), edge_node(EDGE_NODE::P1_SECOND));
+    return connected(edge_node(EDGE_NODE::P2_FIRST), edge_node(EDGE_NODE::P2_SECOND));
+}
+
+/*
+ * Decides the winner of a filled board given as a flat row-major cell array.
+ * Each cell is joined with the already visited neighbours of the same colour
+ * (ROW_LEFT, UP_LEFT, UP_RIGHT) and with the virtual edge nodes it touches,
+ * so a single pass settles both players' connectivity.
+ * Returns NOT_SET if neither player is connected (board not filled).
+ */
+VIRTUAL_PIECE find_filled_board_winner(const VIRTUAL_PIECE *cells, u_int size)
+{
+    HexDisjointSet forest(size);
+
+    for (u_int i = 0; i < size; i++)
+        for (u_int j = 0; j < size; j++)
+        {
+            u_int idx = i * size + j;
+            VIRTUAL_PIECE piece = cells[idx];
+            if (piece == VIRTUAL_PIECE::NOT_SET)
+                continue;
+
+            if (j > 0 && cells[idx - 1] == piece)
+                forest.unite(idx, idx - 1);
+            if (i > 0 && cells[idx - size] == piece)
+                forest.unite(idx, idx - size);
+            if (i > 0 && j < size - 1 && cells[idx - size + 1] == piece)
+                forest.unite(idx, idx - size + 1);
+
+            forest.unite_edges(idx, piece);
+        }
+
+    if (forest.player_connected(VIRTUAL_PIECE::P1))
+        return VIRTUAL_PIECE::P1;
+    if (forest.player_connected(VIRTUAL_PIECE::P2))
+        return VIRTUAL_PIECE::P2;
+    return VIRTUAL_PIECE::NOT_SET;
+}
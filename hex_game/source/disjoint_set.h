@@ -0,0 +1,61 @@
+#ifndef DISJOINT_SET_H
+#define DISJOINT_SET_H
+
+#include "utils.h"
+#include "flat_board.h"
+
+#include <array>
+#include <cstdint>
+
+#define VIRTUAL_PIECE ID_ENUM
+
+// enums
+
+// virtual nodes appended after the board cells, one per player edge
+enum class EDGE_NODE
+{
+    P1_FIRST,  // west edge, column 0
+    P1_SECOND, // east edge, column size - 1
+    P2_FIRST,  // north edge, row 0
+    P2_SECOND, // south edge, row size - 1
+};
+
+// consts
+
+const u_int EDGE_NODE_COUNT = 4;
+
+// Fixed capacity disjoint set forest over the board cells plus the virtual edge nodes
+// (lives entirely on the stack, no heap allocation)
+class HexDisjointSet
+{
+private:
+    u_int size;
+    const EdgeTable *edges;
+    std::array<uint16_t, MAX_BOARD_CELLS + EDGE_NODE_COUNT> parent{};
+    std::array<uint8_t, MAX_BOARD_CELLS + EDGE_NODE_COUNT> rank;
+    std::array<uint16_t, MAX_BOARD_CELLS + EDGE_NODE_COUNT> cell_count; // board cells in the set, valid at the root
+    std::array<uint8_t, MAX_BOARD_CELLS + EDGE_NODE_COUNT> edge_mask;   // bit per EDGE_NODE touched by the set, valid at the root
+
+    uint8_t edges_of(u_int, VIRTUAL_PIECE);
+
+public:
+    HexDisjointSet(u_int size) { reset(size); }
+
+    void reset(u_int);
+    u_int find(u_int);
+    void unite(u_int, u_int);
+    bool connected(u_int a, u_int b) { return find(a) == find(b); }
+    u_int group_size(u_int node) { return cell_count[find(node)]; }
+    bool group_touches(u_int node, EDGE_NODE edge) { return edge_mask[find(node)] & (1 << static_cast<u_int>(edge)); }
+
+    u_int edge_node(EDGE_NODE edge) { return size * size + static_cast<u_int>(edge); }
+    void unite_edges(u_int, VIRTUAL_PIECE);
+    void add_stone(const VIRTUAL_PIECE *, u_int);
+    bool player_connected(VIRTUAL_PIECE);
+};
+
+// Function definitions
+
+VIRTUAL_PIECE find_filled_board_winner(const VIRTUAL_PIECE *, u_int);
+
+#endif
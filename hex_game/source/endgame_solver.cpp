@@ -0,0 +1,204 @@
+#include "endgame_solver.h"
+#include "zobrist.h"
+
+#include <algorithm>
+
+// consts
+
+// hashed in for the side to move, the same stones with the other side to move are another position
+// (neither is 0 so no position hashes to the key of an empty slot, not even the empty board)
+const uint64_t SOLVER_P1_TO_MOVE_KEY = 0x9e3779b97f4a7c15;
+const uint64_t SOLVER_P2_TO_MOVE_KEY = 0xc2b2ae3d27d4eb4f;
+// toggled by every move
+const uint64_t SOLVER_SIDE_SWITCH_KEY = SOLVER_P1_TO_MOVE_KEY ^ SOLVER_P2_TO_MOVE_KEY;
+
+// the table is allocated once and kept between solves
+EndgameSolver::EndgameSolver(u_int size)
+    : size(size), cell_count(size * size), neighbours(&NeighbourTable::for_size(size)), edges(&EdgeTable::for_size(size)), evaluator(size), board(size),
+      table(size_t(1) << SOLVER_TT_BITS, SolverEntry{0, false, 0, CellSet()}), ply_moves(size * size + 1)
+{
+    for (auto &moves : ply_moves)
+        moves.reserve(cell_count);
+}
+
+// collects the group of the stone on the given cell and returns true if it joins both edges of its player
+bool EndgameSolver::connects(u_int cell, CellSet &group)
+{
+    const VIRTUAL_PIECE colour = board[cell];
+    uint8_t touched = (*edges)(cell, colour);
+    u_int stack_size = 0;
+
+    group.reset();
+    group.set(cell);
+    stack[stack_size++] = cell;
+    while (stack_size)
+    {
+        u_int current = stack[--stack_size];
+        for (int16_t next : (*neighbours)[current])
+        {
+            if (next == NO_NEIGHBOUR || board[next] != colour || group[next])
+                continue;
+            group.set(next);
+            touched |= (*edges)(next, colour);
+            stack[stack_size++] = next;
+        }
+    }
+    return touched == 3;
+}
+
+/*
+ * Returns an empty cell joining the edges of `to_move` at once, -1 if there is none.
+ * The player's groups are labelled with the edges they touch in one pass, so each empty cell
+ * is checked against its six neighbours instead of flooding the board from it.
+ */
+int EndgameSolver::find_winning_move(VIRTUAL_PIECE to_move)
+{
+    const uint16_t unlabelled = cell_count;
+    for (u_int idx = 0; idx < cell_count; idx++)
+        group_of[idx] = unlabelled;
+
+    uint16_t group_count = 0;
+    for (u_int idx = 0; idx < cell_count; idx++)
+    {
+        if (board[idx] != to_move || group_of[idx] != unlabelled)
+            continue;
+
+        uint8_t touched = 0;
+        u_int stack_size = 0;
+        group_of[idx] = group_count;
+        stack[stack_size++] = idx;
+        while (stack_size)
+        {
+            u_int current = stack[--stack_size];
+            touched |= (*edges)(current, to_move);
+            for (int16_t next : (*neighbours)[current])
+                if (next != NO_NEIGHBOUR && board[next] == to_move && group_of[next] == unlabelled)
+                {
+                    group_of[next] = group_count;
+                    stack[stack_size++] = next;
+                }
+        }
+        group_edges[group_count++] = touched;
+    }
+
+    for (u_int idx = 0; idx < cell_count; idx++)
+    {
+        if (board[idx] != VIRTUAL_PIECE::NOT_SET)
+            continue;
+
+        uint8_t touched = (*edges)(idx, to_move);
+        for (int16_t next : (*neighbours)[idx])
+            if (next != NO_NEIGHBOUR && board[next] == to_move)
+                touched |= group_edges[group_of[next]];
+        if (touched == 3)
+            return idx;
+    }
+    return -1;
+}
+
+// sorts the moves by decreasing current through their cell, the cells both players' connections lean on come first
+void EndgameSolver::order_moves(std::vector<uint16_t> &moves)
+{
+    evaluator.solve(board);
+    std::stable_sort(moves.begin(), moves.end(), [this](uint16_t a, uint16_t b)
+                     { return evaluator.get_flow(a) > evaluator.get_flow(b); });
+}
+
+/*
+ * Returns true if `to_move` wins the current position, with the cells of the winner's strategy in `proof`
+ * and the winning move in `move`. A won position's proof is its winning move and the proof of the lost child,
+ * a lost position's proof the union of the proofs of every refutation. A cell outside the proof of a refuted
+ * move is at best the same move with the loser holding one more stone elsewhere, so it loses too:
+ * the moves left to search are the intersection of the proofs found so far (the must-play region).
+ */
+bool EndgameSolver::negamax(VIRTUAL_PIECE to_move, uint64_t hash, u_int depth, CellSet &proof, uint16_t &move)
+{
+    if (++nodes > SOLVER_MAX_NODES || (clock && nodes % SEARCH_CLOCK_CHECK_INTERVAL == 0 && clock->timed_out()))
+    {
+        aborted = true;
+        return false;
+    }
+
+    SolverEntry &entry = table[hash & (table.size() - 1)];
+    if (entry.key == hash)
+    {
+        proof = entry.proof;
+        move = entry.move;
+        return entry.win;
+    }
+
+    std::vector<uint16_t> &moves = ply_moves[depth];
+    moves.clear();
+    for (u_int i = 0; i < cell_count; i++)
+        if (board[i] == VIRTUAL_PIECE::NOT_SET)
+            moves.push_back(i);
+    if (moves.empty())
+        throw UNDEFINED_BEHAVIOUR_ERROR;
+
+    // a move joining the player's edges wins on the spot, its group is the proof
+    int winning_move = find_winning_move(to_move);
+    if (winning_move >= 0)
+    {
+        board[winning_move] = to_move;
+        connects(winning_move, proof);
+        board[winning_move] = VIRTUAL_PIECE::NOT_SET;
+        move = winning_move;
+        entry = SolverEntry{hash, true, move, proof};
+        return true;
+    }
+
+    if (moves.size() >= SOLVER_ORDER_MIN_EMPTY)
+        order_moves(moves);
+
+    CellSet must_play;
+    must_play.set();
+    CellSet loss_proof;
+    CellSet child_proof;
+    uint16_t child_move;
+    for (uint16_t cell : moves)
+    {
+        if (!must_play[cell])
+            continue;
+
+        board[cell] = to_move;
+        bool child_won = negamax(opponent_of(to_move), hash ^ zobrist_key(cell, to_move) ^ SOLVER_SIDE_SWITCH_KEY, depth + 1, child_proof, child_move);
+        board[cell] = VIRTUAL_PIECE::NOT_SET;
+        if (aborted)
+            return false;
+
+        if (!child_won)
+        {
+            proof = child_proof;
+            proof.set(cell);
+            move = cell;
+            entry = SolverEntry{hash, true, cell, proof};
+            return true;
+        }
+        loss_proof |= child_proof;
+        must_play &= child_proof;
+    }
+
+    proof = loss_proof;
+    move = moves.front();
+    entry = SolverEntry{hash, false, move, proof};
+    return false;
+}
+
+// solves the position with `to_move` to play, a won position also returns the winning move
+// a solve given the clock of a move gives up once the move's time runs out
+SOLVER_RESULT EndgameSolver::solve(const FlatBoard &position, VIRTUAL_PIECE to_move, u_int &move, const SearchClock *move_clock)
+{
+    board = position;
+    nodes = 0;
+    aborted = false;
+    clock = move_clock;
+
+    CellSet proof;
+    uint16_t best_move;
+    bool won = negamax(to_move, zobrist_hash(board) ^ (to_move == VIRTUAL_PIECE::P1 ? SOLVER_P1_TO_MOVE_KEY : SOLVER_P2_TO_MOVE_KEY), 0, proof, best_move);
+    if (aborted)
+        return SOLVER_RESULT::Unknown;
+
+    move = best_move;
+    return won ? SOLVER_RESULT::Win : SOLVER_RESULT::Loss;
+}
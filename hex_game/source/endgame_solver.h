@@ -0,0 +1,93 @@
+#ifndef ENDGAME_SOLVER_H
+#define ENDGAME_SOLVER_H
+
+#include "utils.h"
+#include "flat_board.h"
+#include "resistance.h"
+#include "search_budget.h"
+
+#include <array>
+#include <bitset>
+#include <vector>
+#include <cstdint>
+
+#define VIRTUAL_PIECE ID_ENUM
+
+// consts
+
+// the move generators hand positions with at most this many empty cells to the solver
+const u_int SOLVER_MAX_EMPTY_CELLS = 20;
+// nodes a solve may visit before giving up, the move is then left to the regular search
+// (about 0.5 s at the ~2.6 us per node of BM_EndgameSolve/5, the clock of a timed move usually stops it first)
+const u_int SOLVER_MAX_NODES = 200000;
+// nodes with at least this many empty cells try their moves in the order of the resistance evaluator's flow,
+// smaller ones are cheaper to search than to order
+const u_int SOLVER_ORDER_MIN_EMPTY = 8;
+const u_int SOLVER_TT_BITS = 16;
+
+// enums
+
+enum class SOLVER_RESULT
+{
+    Win,
+    Loss,
+    Unknown, // the node budget or the move's time ran out
+};
+
+// typedefs
+
+// set of flat cell indices
+typedef std::bitset<MAX_BOARD_CELLS> CellSet;
+
+// structs
+
+// solved position, the proof holds the cells the winner's strategy depends on
+struct SolverEntry
+{
+    uint64_t key; // zobrist hash with the side to move, 0 for an empty slot
+    bool win;     // for the side to move
+    uint16_t move; // winning move of the side to move
+    CellSet proof;
+};
+
+/*
+ * Exact solver for positions with few empty cells: a negamax search over won and lost values, so every node
+ * stops at its first winning move (alpha-beta with a null window), with
+ *  - a transposition table of solved positions kept between solves,
+ *  - must-play pruning: every lost position returns the cells its winner's strategy needs (the proof),
+ *    a move outside the proof of a refuted move loses as well, so only the intersection of the proofs
+ *    found so far is searched,
+ *  - move ordering by the current through each cell in the resistance evaluator, after the immediate wins.
+ * A won or lost position is exact whatever the opponent plays, a solve running out of nodes or time reports Unknown.
+ */
+class EndgameSolver
+{
+private:
+    u_int size;
+    u_int cell_count;
+    const NeighbourTable *neighbours;
+    const EdgeTable *edges;
+    ResistanceEvaluator evaluator;
+    FlatBoard board;
+    std::vector<SolverEntry> table;
+    std::vector<std::vector<uint16_t>> ply_moves; // move list of every depth, reused between nodes
+    std::array<uint16_t, MAX_BOARD_CELLS> stack;
+    std::array<uint16_t, MAX_BOARD_CELLS> group_of;  // group label of each stone of the side to move, scratch of one node
+    std::array<uint8_t, MAX_BOARD_CELLS> group_edges; // edges touched by each labelled group
+    u_int nodes = 0;
+    bool aborted = false;
+    const SearchClock *clock = nullptr; // of the move being solved, none for an untimed solve
+
+    bool connects(u_int, CellSet &);
+    int find_winning_move(VIRTUAL_PIECE);
+    void order_moves(std::vector<uint16_t> &);
+    bool negamax(VIRTUAL_PIECE, uint64_t, u_int, CellSet &, uint16_t &);
+
+public:
+    EndgameSolver(u_int);
+
+    SOLVER_RESULT solve(const FlatBoard &, VIRTUAL_PIECE, u_int &, const SearchClock * = nullptr);
+    u_int get_nodes() { return nodes; }
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "flat_board.h"
+
+// builds the neighbour indices of every cell on a board of the given size
+NeighbourTable::NeighbourTable(u_int size) : rows(size * size)
+{
+    for (u_int i = 0; i < size; i++)
+        for (u_int j = 0; j < size; j++)
+            for (int direction = 0; direction < NEIGHBOUR_COUNT; direction++)
+            {
+                int row = i + NEIGHBOUR_OFFSET[direction].first;
+                int col = j + NEIGHBOUR_OFFSET[direction].second;
+                bool on_board = row >= 0 && row < static_cast<int>(size) && col >= 0 && col < static_cast<int>(size);
+                rows[i * size + j][direction] = on_board ? row * size + col : NO_NEIGHBOUR;
+            }
+}
+
+// returns the shared neighbour table for the given board size
+const NeighbourTable &NeighbourTable::for_size(u_int size)
+{
+    static const std::vector<NeighbourTable> tables = []()
+    {
+        std::vector<NeighbourTable> tables;
+        for (u_int i = 0; i <= MAX_BOARD_SIZE; i++)
+            tables.push_back(NeighbourTable(i));
+        return tables;
+    }();
+
+    if (size > MAX_BOARD_SIZE)
+        throw UNDEFINED_BEHAVIOUR_ERROR;
+    return tables[size];
+}
+
+// marks the cells on the edges of each player on a board of the given size
+EdgeTable::EdgeTable(u_int size) : masks(size * size, 0)
+{
+    for (u_int i = 0; i < size; i++)
+        for (u_int j = 0; j < size; j++)
+            masks[i * size + j] = (j == 0) | (j == size - 1) << 1 | (i == 0) << 2 | (i == size - 1) << 3;
+}
+
+// returns the shared edge table for the given board size
+const EdgeTable &EdgeTable::for_size(u_int size)
+{
+    static const std::vector<EdgeTable> tables = []()
+    {
+        std::vector<EdgeTable> tables;
+        for (u_int i = 0; i <= MAX_BOARD_SIZE; i++)
+            tables.push_back(EdgeTable(i));
+        return tables;
+    }();
+
+    if (size > MAX_BOARD_SIZE)
+        throw UNDEFINED_BEHAVIOUR_ERROR;
+    return tables[size];
+}
@@ -0,0 +1,115 @@
+#ifndef FLAT_BOARD_H
+#define FLAT_BOARD_H
+
+#include "utils.h"
+
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#define VIRTUAL_PIECE ID_ENUM
+
+// enums
+
+enum class NEIGHBOUR
+{
+    UP_LEFT,
+    UP_RIGHT,
+    ROW_RIGHT,
+    ROW_LEFT,
+    DOWN_RIGHT,
+    DOWN_LEFT,
+};
+
+// consts
+
+const int NEIGHBOUR_COUNT = 6;
+const int16_t NO_NEIGHBOUR = -1;
+
+// offset in (row, column) of the neighbour in each direction, indexed by NEIGHBOUR
+constexpr std::array<std::pair<int, int>, NEIGHBOUR_COUNT> NEIGHBOUR_OFFSET =
+    {{
+        {-1, 0},
+        {-1, 1},
+        {0, 1},
+        {0, -1},
+        {1, 0},
+        {1, -1},
+    }};
+
+const std::unordered_map<NEIGHBOUR, std::pair<int, int>> DIRECTION_OFFSET =
+    {
+        {NEIGHBOUR::UP_LEFT, NEIGHBOUR_OFFSET[static_cast<int>(NEIGHBOUR::UP_LEFT)]},
+        {NEIGHBOUR::UP_RIGHT, NEIGHBOUR_OFFSET[static_cast<int>(NEIGHBOUR::UP_RIGHT)]},
+        {NEIGHBOUR::ROW_RIGHT, NEIGHBOUR_OFFSET[static_cast<int>(NEIGHBOUR::ROW_RIGHT)]},
+        {NEIGHBOUR::ROW_LEFT, NEIGHBOUR_OFFSET[static_cast<int>(NEIGHBOUR::ROW_LEFT)]},
+        {NEIGHBOUR::DOWN_RIGHT, NEIGHBOUR_OFFSET[static_cast<int>(NEIGHBOUR::DOWN_RIGHT)]},
+        {NEIGHBOUR::DOWN_LEFT, NEIGHBOUR_OFFSET[static_cast<int>(NEIGHBOUR::DOWN_LEFT)]},
+};
+
+// typedefs
+
+// flat indices of a cell's neighbours ordered as NEIGHBOUR, NO_NEIGHBOUR when off the board
+typedef std::array<int16_t, NEIGHBOUR_COUNT> NeighbourRow;
+
+// Precomputed neighbour indices for every cell of a given board size
+// (built once per size and shared by every board of that size)
+class NeighbourTable
+{
+private:
+    std::vector<NeighbourRow> rows;
+
+    NeighbourTable(u_int);
+
+public:
+    static const NeighbourTable &for_size(u_int);
+
+    const NeighbourRow &operator[](u_int idx) const { return rows[idx]; }
+};
+
+// Precomputed player edges of every cell for a given board size
+// (built once per size and shared by every board of that size)
+// A player's mask has bit 0 set on their first edge (west for P1, north for P2) and bit 1 on their second one
+class EdgeTable
+{
+private:
+    std::vector<uint8_t> masks; // P1's mask in bits 0 and 1, P2's in bits 2 and 3
+
+    EdgeTable(u_int);
+
+public:
+    static const EdgeTable &for_size(u_int);
+
+    uint8_t operator()(u_int idx, VIRTUAL_PIECE p_id) const { return (masks[idx] >> (2 * player_slot(p_id))) & 3; }
+};
+
+// Contiguous one byte per cell row-major hex board
+class FlatBoard
+{
+private:
+    u_int size;
+    std::vector<VIRTUAL_PIECE> cells;
+    const NeighbourTable *neighbour_table;
+
+public:
+    FlatBoard(u_int size) : size(size), cells(size * size, VIRTUAL_PIECE::NOT_SET), neighbour_table(&NeighbourTable::for_size(size)) {}
+
+    u_int get_size() const { return size; }
+    u_int cell_count() const { return cells.size(); }
+    u_int index(u_int row, u_int col) const { return row * size + col; }
+    std::pair<u_int, u_int> coords(u_int idx) const { return {idx / size, idx % size}; }
+
+    VIRTUAL_PIECE &operator[](u_int idx) { return cells[idx]; }
+    VIRTUAL_PIECE operator[](u_int idx) const { return cells[idx]; }
+    VIRTUAL_PIECE &operator()(u_int row, u_int col) { return cells[row * size + col]; }
+    VIRTUAL_PIECE operator()(u_int row, u_int col) const { return cells[row * size + col]; }
+
+    VIRTUAL_PIECE *data() { return cells.data(); }
+    const VIRTUAL_PIECE *data() const { return cells.data(); }
+
+    const NeighbourRow &neighbours(u_int idx) const { return (*neighbour_table)[idx]; }
+    int16_t neighbour(u_int idx, NEIGHBOUR direction) const { return (*neighbour_table)[idx][static_cast<int>(direction)]; }
+};
+
+#endif
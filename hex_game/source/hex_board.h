@@ -2,65 +2,38 @@
 #define HEX_BOARD_H
 
 #include "utils.h"
+#include "thread_pool.h"
+#include "disjoint_set.h"
+#include "flat_board.h"
+#include "rng.h"
+#include "playout.h"
+#include "bitboard.h"
+#include "mcts.h"
+#include "parallel_mcts.h"
+#include "search_budget.h"
+#include "zobrist.h"
+#include "transposition_table.h"
+#include "board_renderer.h"
+#include "move_stream.h"
+#include "resistance.h"
+#include "endgame_solver.h"
 
 #include <vector>
 #include <iostream>
-#include <unordered_map>
 #include <map>
-#include <set>
-#include <list>
-#include <cstdarg>
+#include <atomic>
+#include <future>
 
 #define VIRTUAL_PIECE ID_ENUM
 #define BoardType REAL_VIRTUAL
 
-// structs
-
-struct GamePiece
-{
-    std::string colour;
-    std::string piece;
-};
-
-// enums
-
-enum class NEIGHBOUR
-{
-    UP_LEFT,
-    UP_RIGHT,
-    ROW_RIGHT,
-    ROW_LEFT,
-    DOWN_RIGHT,
-    DOWN_LEFT,
-};
-
-// consts
-
-const std::unordered_map<NEIGHBOUR, std::pair<int, int>> DIRECTION_OFFSET =
-    {
-        {NEIGHBOUR::UP_LEFT, std::pair<int, int>{-1, 0}},
-        {NEIGHBOUR::UP_RIGHT, std::pair<int, int>{-1, 1}},
-        {NEIGHBOUR::ROW_RIGHT, std::pair<int, int>{0, 1}},
-        {NEIGHBOUR::ROW_LEFT, std::pair<int, int>{0, -1}},
-        {NEIGHBOUR::DOWN_RIGHT, std::pair<int, int>{1, 0}},
-        {NEIGHBOUR::DOWN_LEFT, std::pair<int, int>{1, -1}},
-};
-
-// cannot hash pairs out of the box so use map instead
-const std::map<std::pair<int, int>, std::string> PIECE_SEPARATORS =
-    {
-        {std::pair<int, int>{-1, 0}, "\\"},
-        {std::pair<int, int>{-1, 1}, "/"},
-        {std::pair<int, int>{0, 1}, "-"},
-};
-
 // class prototypes
 
 class HexBoardReal;
 class HexBoardVirtual;
 
 // HexBoard abstract base class
-class HexBoardABC
+class HexBoardABC : public MoveObserver
 {
     friend class HexBoardReal;
     friend class HexBoardVirtual;
@@ -68,29 +41,31 @@ class HexBoardABC
 protected:
     bool *win_state = new bool(false);
     const u_int size;
-    const std::unordered_map<VIRTUAL_PIECE, std::pair<std::set<std::pair<u_int, u_int>>, std::set<std::pair<u_int, u_int>>>> player_targets;
-    std::vector<std::vector<VIRTUAL_PIECE>> game_board;
+    FlatBoard game_board;
+    HexDisjointSet groups; // same colour groups and player edges of game_board, updated on every move
+    uint64_t hash = 0;     // zobrist hash of game_board, updated on every move
 
-    virtual std::string serialise() = 0;
+    virtual void serialise(std::string &) = 0;
     virtual void update_board(u_int, u_int, VIRTUAL_PIECE) = 0;
 
 public:
-    HexBoardABC(u_int size) : size(size), game_board(generate_board()), player_targets(generate_player_targets()) {}
-    HexBoardABC(HexBoardABC *root_board) : size(root_board->size), win_state(root_board->win_state), game_board(root_board->game_board), player_targets(root_board->player_targets) {}
+    HexBoardABC(u_int size) : size(size), game_board(generate_board()), groups(size) {}
+    HexBoardABC(HexBoardABC *root_board) : win_state(root_board->win_state), size(root_board->size), game_board(root_board->game_board), groups(root_board->groups), hash(root_board->hash) {}
     virtual ~HexBoardABC() {}
 
-    std::vector<std::vector<VIRTUAL_PIECE>> get_game_board() { return game_board; }
+    const FlatBoard &get_game_board() { return game_board; }
     bool get_win_state() { return *win_state; }
     u_int get_size() { return size; }
+    uint64_t get_hash() { return hash; }
 
     virtual BoardType get_board_type() = 0;
 
-    virtual std::vector<std::vector<VIRTUAL_PIECE>> generate_board();
-    virtual std::unordered_map<VIRTUAL_PIECE, std::pair<std::set<std::pair<u_int, u_int>>, std::set<std::pair<u_int, u_int>>>> generate_player_targets();
+    virtual FlatBoard generate_board();
     bool player_has_won(VIRTUAL_PIECE);
-    virtual void update(va_list args);
-    void check_win_on_move(u_int, u_int, VIRTUAL_PIECE);
-    bool find_any_path_one_to_many(std::pair<u_int, u_int>, const std::set<std::pair<u_int, u_int>> &, std::vector<std::vector<bool>> = std::vector<std::vector<bool>>(), std::list<std::pair<u_int, u_int>> = std::list<std::pair<u_int, u_int>>());
+    u_int get_group_size(u_int, u_int);
+    bool in_same_group(std::pair<u_int, u_int>, std::pair<u_int, u_int>);
+    void update(const Move &move) override { update_board(move.row, move.col, move.piece); }
+    void check_win_on_move(VIRTUAL_PIECE);
 
     friend std::ostream &operator<<(std::ostream &, HexBoardABC *);
 };
@@ -100,66 +75,77 @@ class HexBoardReal : public HexBoardABC
 {
 private:
     const std::map<std::string, std::pair<u_int, u_int>> str_cell_id_map;
+    BoardRenderer renderer; // also the layout the board is serialised from
 
     static std::map<std::string, std::pair<u_int, u_int>> generate_str_cell_id_map(u_int);
 
-    std::string get_colour_between_pieces(std::pair<int, int>, NEIGHBOUR);
-    std::string get_separator_between_pieces(std::pair<int, int>, NEIGHBOUR);
-    std::string generate_separator_row(int);
-
-    void box_board(std::string &);
-    void add_top_padding(std::string &, std::string);
-    void add_left_padding(std::string &, std::string);
-    void add_right_padding(std::string &, std::string);
-    void add_bottom_padding(std::string &, std::string);
-
-    void label_board(std::string &);
-    void add_col_labels(std::string &);
-    void add_row_labels(std::string &);
-
 protected:
-    static std::string get_piece_symbol(VIRTUAL_PIECE);
-    std::string serialise();
     void update_board(u_int, u_int, VIRTUAL_PIECE);
 
 public:
-    HexBoardReal(u_int size) : HexBoardABC(size), str_cell_id_map(generate_str_cell_id_map(size)) {}
+    HexBoardReal(u_int size) : HexBoardABC(size), str_cell_id_map(generate_str_cell_id_map(size)), renderer(size) {}
 
     ~HexBoardReal() { delete win_state; }
 
     BoardType get_board_type();
     std::pair<u_int, u_int> get_cell_by_str_id(std::string);
     bool cell_is_populated(std::string &);
+    void draw(std::ostream &out) { renderer.draw(out); }
+    void redraw(std::ostream &out) { renderer.redraw(out); }
+    size_t get_serialised_length() { return renderer.get_serialised_length(); }
+    void serialise(std::string &buffer) { renderer.serialise(buffer); }
+    std::string serialise();
 };
 
 // Virtual Hex game board used for montecarlo simulations
 class HexBoardVirtual : public HexBoardABC
 {
 protected:
-    std::vector<std::vector<VIRTUAL_PIECE>> &&root_board;
-    std::string serialise() { throw UNDEFINED_BEHAVIOUR_ERROR; }
+    FlatBoard &&root_board;
+    ThreadPool sim_pool;
+    TranspositionTable transposition_table; // shared by every search of this board, so statistics carry over between moves
+    MCTSEngine mcts_engine;
+    ParallelMCTSEngine parallel_mcts_engine;
+    FlatBoard ponder_board; // snapshot searched while pondering, the shared root board may change under it
+    std::atomic<bool> ponder_stop;
+    std::future<void> ponder_result;
+    const PLAYOUT_POLICY playout_policy;
+    ResistanceEvaluator evaluator; // static evaluator of the resistance engine and prior of the serial tree search
+    EndgameSolver solver;          // exact solver taking over both searches once few cells are left
+    void serialise(std::string &) { throw UNDEFINED_BEHAVIOUR_ERROR; }
     void update_board(u_int, u_int, VIRTUAL_PIECE);
-    bool thread_safe_player_has_won(std::vector<std::vector<VIRTUAL_PIECE>>, VIRTUAL_PIECE);
-    bool thread_safe_find_any_path_one_to_many(std::vector<std::vector<VIRTUAL_PIECE>>, std::pair<u_int, u_int>, const std::set<std::pair<u_int, u_int>> &, std::vector<std::vector<bool>> = std::vector<std::vector<bool>>(), std::list<std::pair<u_int, u_int>> = std::list<std::pair<u_int, u_int>>());
-    void thread_safe_montecarlo_sim(atomwrapper<int> &, std::vector<std::pair<u_int, u_int>>, int, VIRTUAL_PIECE, u_int);
+    std::pair<int, u_int> thread_safe_montecarlo_sim(std::pair<u_int, u_int>, VIRTUAL_PIECE, u_int, const SearchClock &);
     std::vector<std::pair<u_int, u_int>> get_possible_moves();
+    bool find_solved_move(VIRTUAL_PIECE, u_int, const SearchClock &, std::pair<u_int, u_int> &);
 
 public:
-    HexBoardVirtual(HexBoardABC *root_board) : HexBoardABC(root_board), root_board(std::move(root_board->game_board)) {}
+    HexBoardVirtual(HexBoardABC *root_board, u_int sim_threads = ThreadPool::default_size(), PLAYOUT_POLICY playout_policy = PLAYOUT_POLICY::Uniform)
+        : HexBoardABC(root_board), root_board(std::move(root_board->game_board)), sim_pool(sim_threads),
+                                                 mcts_engine(&transposition_table), parallel_mcts_engine(sim_pool, &transposition_table),
+                                                 ponder_board(root_board->size), ponder_stop(false), playout_policy(playout_policy),
+                                                 evaluator(root_board->size), solver(root_board->size)
+    {
+        mcts_engine.set_playout_policy(playout_policy);
+        mcts_engine.set_evaluator(&evaluator);
+        parallel_mcts_engine.set_playout_policy(playout_policy);
+    }
 
-    ~HexBoardVirtual() {}
+    ~HexBoardVirtual() { stop_pondering(); }
 
     BoardType get_board_type();
-    std::pair<u_int, u_int> generate_move(VIRTUAL_PIECE);
-    std::vector<std::vector<VIRTUAL_PIECE>> generate_board() override { throw UNDEFINED_BEHAVIOUR_ERROR; }
-    virtual std::unordered_map<VIRTUAL_PIECE, std::pair<std::set<std::pair<u_int, u_int>>, std::set<std::pair<u_int, u_int>>>> generate_player_targets() override { throw UNDEFINED_BEHAVIOUR_ERROR; }
+    std::pair<u_int, u_int> generate_move(VIRTUAL_PIECE, SearchBudget = SearchBudget());
+    std::pair<u_int, u_int> generate_mcts_move(VIRTUAL_PIECE, SearchBudget = SearchBudget(), MCTS_MODE = MCTS_MODE::Serial);
+    std::pair<u_int, u_int> generate_resistance_move(VIRTUAL_PIECE);
+    void start_pondering(VIRTUAL_PIECE);
+    void stop_pondering();
+    FlatBoard generate_board() override { throw UNDEFINED_BEHAVIOUR_ERROR; }
 };
 
 // Hex board factory
 class HexBoardFactory
 {
 public:
-    static HexBoardABC *make(HexBoardABC *);
+    static HexBoardABC *make(HexBoardABC *, u_int = ThreadPool::default_size(), PLAYOUT_POLICY = PLAYOUT_POLICY::Uniform);
     static HexBoardABC *make(u_int);
     static void init_boards(HexBoardABC *&, HexBoardABC *&, u_int, bool);
 };
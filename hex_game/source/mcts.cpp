@@ -0,0 +1,251 @@
+#include "mcts.h"
+
+#include <algorithm>
+#include <cmath>
+
+// scales transposition table statistics down to at most MCTS_TT_PRIOR_VISITS visits, keeping their win rate
+TTStats cap_prior(TTStats stats)
+{
+    if (stats.visits <= MCTS_TT_PRIOR_VISITS)
+        return stats;
+    return TTStats{MCTS_TT_PRIOR_VISITS, static_cast<uint32_t>(static_cast<uint64_t>(stats.wins) * MCTS_TT_PRIOR_VISITS / stats.visits)};
+}
+
+// picks the child maximising the UCT score, unvisited children first
+uint32_t MCTSEngine::select_child(uint32_t node)
+{
+    const MCTSNode &parent = arena[node];
+    float log_visits = std::log(static_cast<float>(std::max<uint32_t>(1, parent.visits)));
+
+    uint32_t best_child = parent.first_child;
+    float best_score = -1.0f;
+    for (uint32_t child = parent.first_child; child < parent.first_child + parent.child_count; child++)
+    {
+        if (!arena[child].visits)
+            return child;
+
+        float visits = static_cast<float>(arena[child].visits);
+        float score = arena[child].wins / visits + MCTS_EXPLORATION * std::sqrt(log_visits / visits);
+        if (score > best_score)
+        {
+            best_score = score;
+            best_child = child;
+        }
+    }
+    return best_child;
+}
+
+// appends one child per empty cell of the node's position, in random order
+// children of a node close to the root start from the resistance evaluator's prior when one is set,
+// children of positions already in the transposition table start from their stored statistics
+void MCTSEngine::expand(uint32_t node, const FlatBoard &board, uint64_t hash, VIRTUAL_PIECE to_move, bool seed_prior)
+{
+    empty_cells.clear();
+    for (u_int i = 0; i < board.cell_count(); i++)
+        if (board[i] == VIRTUAL_PIECE::NOT_SET)
+            empty_cells.push_back(i);
+
+    if (empty_cells.empty() || arena.size() + empty_cells.size() > MCTS_MAX_NODES)
+        return;
+
+    fast_shuffle(empty_cells.begin(), empty_cells.end(), rng);
+
+    arena[node].first_child = arena.size();
+    arena[node].child_count = empty_cells.size();
+    for (uint16_t cell : empty_cells)
+        arena.push_back(MCTSNode{0, 0, cell, 0, 0.0f});
+
+    if (evaluator && seed_prior)
+    {
+        evaluator->solve(board);
+        double max_flow = 0.0;
+        for (uint16_t cell : empty_cells)
+            max_flow = std::max(max_flow, evaluator->get_flow(cell));
+        if (max_flow > 0.0)
+            for (uint32_t child = arena[node].first_child; child < arena.size(); child++)
+            {
+                arena[child].visits = MCTS_PRIOR_VISITS;
+                arena[child].wins = static_cast<float>(MCTS_PRIOR_VISITS * evaluator->get_flow(arena[child].move) / max_flow);
+            }
+    }
+
+    if (!transposition_table)
+        return;
+
+    transposition_table->store(hash, TTStats{arena[node].visits, static_cast<uint32_t>(arena[node].wins)});
+
+    TTStats stats;
+    for (uint32_t child = arena[node].first_child; child < arena.size(); child++)
+        if (transposition_table->probe(hash ^ zobrist_key(arena[child].move, to_move), stats))
+        {
+            stats = cap_prior(stats);
+            arena[child].visits = stats.visits;
+            arena[child].wins = stats.wins;
+        }
+}
+
+// credits the playout result to every node on the selected path
+void MCTSEngine::backpropagate(VIRTUAL_PIECE winner, VIRTUAL_PIECE root_mover)
+{
+    VIRTUAL_PIECE mover = root_mover;
+    for (uint32_t node : path)
+    {
+        arena[node].visits += 1;
+        if (mover == winner)
+            arena[node].wins += 1.0f;
+        mover = opponent_of(mover);
+    }
+}
+
+// writes the statistics of every well visited node to the transposition table
+void MCTSEngine::store_tree(uint64_t root_hash, VIRTUAL_PIECE p_id)
+{
+    if (!transposition_table)
+        return;
+
+    std::vector<std::pair<uint32_t, uint64_t>> pending = {{0, root_hash}};
+    std::vector<VIRTUAL_PIECE> pending_to_move = {p_id};
+    while (!pending.empty())
+    {
+        auto [node, hash] = pending.back();
+        VIRTUAL_PIECE to_move = pending_to_move.back();
+        pending.pop_back();
+        pending_to_move.pop_back();
+
+        transposition_table->store(hash, TTStats{arena[node].visits, static_cast<uint32_t>(arena[node].wins)});
+        for (uint32_t child = arena[node].first_child; child < arena[node].first_child + arena[node].child_count; child++)
+            if (arena[child].visits >= MCTS_EXPANSION_THRESHOLD)
+            {
+                pending.emplace_back(child, hash ^ zobrist_key(arena[child].move, to_move));
+                pending_to_move.push_back(opponent_of(to_move));
+            }
+    }
+}
+
+/*
+ * Runs iterations of selection, expansion, random playout and backpropagation from the given position
+ * with `p_id` to move until the budget runs out (`default_playouts` when the budget sets no limit)
+ * or `stop` is raised. A tree already rooted at this position is grown further instead of rebuilt.
+ * Nodes are only expanded once visited MCTS_EXPANSION_THRESHOLD times to keep the arena small.
+ * The zobrist hash of each position is carried down the descent to share statistics through the
+ * transposition table, with transpositions inside this search and with later searches.
+ */
+void MCTSEngine::grow(const FlatBoard &root_board, uint64_t root_hash, VIRTUAL_PIECE p_id, SearchBudget budget, u_int default_playouts,
+                      const std::atomic<bool> *stop)
+{
+    const SearchClock clock(budget, default_playouts);
+
+    if (arena.empty() || tree_hash != root_hash)
+    {
+        arena.clear();
+        arena.push_back(MCTSNode{0, 0, 0, 0, 0.0f});
+        tree_hash = root_hash;
+    }
+    if (!arena[0].child_count)
+        expand(0, root_board, root_hash, p_id, true);
+    if (!arena[0].child_count)
+        throw UNDEFINED_BEHAVIOUR_ERROR;
+
+    FlatBoard board = root_board;
+    for (u_int i = 0; !clock.expired(i) && !(stop && stop->load(std::memory_order_relaxed)); i++)
+    {
+        board = root_board;
+        path.clear();
+        path.push_back(0);
+
+        uint32_t node = 0;
+        uint64_t hash = root_hash;
+        VIRTUAL_PIECE to_move = p_id;
+        while (arena[node].child_count)
+        {
+            node = select_child(node);
+            board[arena[node].move] = to_move;
+            hash ^= zobrist_key(arena[node].move, to_move);
+            to_move = opponent_of(to_move);
+            path.push_back(node);
+        }
+
+        if (arena[node].visits >= MCTS_EXPANSION_THRESHOLD)
+        {
+            expand(node, board, hash, to_move, path.size() <= MCTS_PRIOR_DEPTH + 1);
+            if (arena[node].child_count)
+            {
+                node = arena[node].first_child;
+                board[arena[node].move] = to_move;
+                to_move = opponent_of(to_move);
+                path.push_back(node);
+            }
+        }
+
+        playout_kernel.prepare(board);
+        backpropagate(playout_kernel.run(to_move, rng), opponent_of(p_id));
+    }
+
+    store_tree(root_hash, p_id);
+}
+
+// re-roots the tree at the child reached by `piece` playing `cell`, keeping the statistics of that subtree
+// the subtree is copied breadth first into a fresh arena so children stay contiguous, any other tree is dropped
+// `next_hash` is the board's own hash after the move, a kept tree rooted anywhere else is dropped instead
+// (this runs while a move is broadcast to every observer, so it must not throw)
+void MCTSEngine::advance_root(u_int cell, VIRTUAL_PIECE piece, uint64_t next_hash)
+{
+    uint32_t next_root = 0;
+    if (!arena.empty())
+        for (uint32_t child = arena[0].first_child; child < arena[0].first_child + arena[0].child_count; child++)
+            if (arena[child].move == cell)
+                next_root = child;
+
+    if (!next_root)
+    {
+        arena.clear();
+        return;
+    }
+
+    reroot_arena.clear();
+    reroot_source.clear();
+    reroot_arena.push_back(arena[next_root]);
+    reroot_source.push_back(next_root);
+    for (uint32_t i = 0; i < reroot_arena.size(); i++)
+    {
+        const MCTSNode &source = arena[reroot_source[i]];
+        if (!source.child_count)
+            continue;
+
+        reroot_arena[i].first_child = reroot_arena.size();
+        for (uint32_t child = source.first_child; child < source.first_child + source.child_count; child++)
+        {
+            reroot_arena.push_back(arena[child]);
+            reroot_source.push_back(child);
+        }
+    }
+
+    arena.swap(reroot_arena);
+    tree_hash ^= zobrist_key(cell, piece);
+    if (tree_hash != next_hash)
+        arena.clear();
+}
+
+// adds the visit count of every root move to the per cell totals
+void MCTSEngine::accumulate_root_visits(std::vector<uint32_t> &visits_by_cell)
+{
+    for (uint32_t child = arena[0].first_child; child < arena[0].first_child + arena[0].child_count; child++)
+        visits_by_cell[arena[child].move] += arena[child].visits;
+}
+
+// returns the flat index of the most visited root move
+u_int MCTSEngine::best_root_move()
+{
+    uint32_t best_child = arena[0].first_child;
+    for (uint32_t child = arena[0].first_child; child < arena[0].first_child + arena[0].child_count; child++)
+        if (arena[child].visits > arena[best_child].visits)
+            best_child = child;
+    return arena[best_child].move;
+}
+
+// grows a tree from the given position and returns the most visited root move
+std::pair<u_int, u_int> MCTSEngine::search(const FlatBoard &root_board, uint64_t root_hash, VIRTUAL_PIECE p_id, SearchBudget budget)
+{
+    grow(root_board, root_hash, p_id, budget);
+    return root_board.coords(best_root_move());
+}
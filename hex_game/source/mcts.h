@@ -0,0 +1,95 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "utils.h"
+#include "flat_board.h"
+#include "bitboard.h"
+#include "search_budget.h"
+#include "rng.h"
+#include "playout.h"
+#include "zobrist.h"
+#include "transposition_table.h"
+#include "resistance.h"
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+#define VIRTUAL_PIECE ID_ENUM
+
+// consts
+
+const u_int MCTS_PLAYOUTS = 100000;
+const u_int MCTS_EXPANSION_THRESHOLD = 8;
+const u_int MCTS_MAX_NODES = 1 << 22;
+const float MCTS_EXPLORATION = 0.7f;
+// playouts after which pondering gives up on its own if the opponent still has not moved
+const u_int MCTS_PONDER_PLAYOUTS = 50 * MCTS_PLAYOUTS;
+// most visits a transposition table entry may seed a new node with, so old statistics cannot drown new playouts
+const uint32_t MCTS_TT_PRIOR_VISITS = 64;
+// visits the resistance evaluator seeds every child of a node close to the root with, at a win rate proportional
+// to the current through the child's cell (the most crossed cell of the position starts as a sure win)
+const uint32_t MCTS_PRIOR_VISITS = 30;
+// expansions up to this many moves below the root are seeded, deeper ones are too numerous to pay for a solve each
+const u_int MCTS_PRIOR_DEPTH = 1;
+
+// enums
+
+enum class MCTS_MODE
+{
+    Serial,
+    RootParallel, // one independent tree per worker, root statistics merged at the end
+    TreeParallel, // all workers grow one shared tree with atomic statistics and virtual loss
+};
+
+// structs
+
+// search tree node, children of a node are stored contiguously in the arena
+struct MCTSNode
+{
+    uint32_t first_child; // arena index of the first child, 0 while not expanded
+    uint16_t child_count;
+    uint16_t move;  // flat index of the cell played to reach this node
+    uint32_t visits;
+    float wins;     // playouts won by the player who played `move`
+};
+
+// UCT Monte Carlo tree search engine
+class MCTSEngine
+{
+private:
+    std::vector<MCTSNode> arena;
+    std::vector<MCTSNode> reroot_arena;
+    std::vector<uint32_t> reroot_source;
+    uint64_t tree_hash = 0; // zobrist hash of the position at the root of the arena
+    std::vector<uint16_t> empty_cells;
+    std::vector<uint32_t> path;
+    Xoshiro256 rng;
+    PlayoutKernel playout_kernel;
+    TranspositionTable *transposition_table;
+    ResistanceEvaluator *evaluator = nullptr;
+
+    uint32_t select_child(uint32_t);
+    void expand(uint32_t, const FlatBoard &, uint64_t, VIRTUAL_PIECE, bool);
+    void backpropagate(VIRTUAL_PIECE, VIRTUAL_PIECE);
+    void store_tree(uint64_t, VIRTUAL_PIECE);
+
+public:
+    MCTSEngine(TranspositionTable *transposition_table = nullptr) : rng(make_worker_rng()), transposition_table(transposition_table) {}
+
+    void set_transposition_table(TranspositionTable *table) { transposition_table = table; }
+    void set_playout_policy(PLAYOUT_POLICY policy) { playout_kernel.set_policy(policy); }
+    void set_evaluator(ResistanceEvaluator *prior) { evaluator = prior; }
+
+    void grow(const FlatBoard &, uint64_t, VIRTUAL_PIECE, SearchBudget = SearchBudget(), u_int = MCTS_PLAYOUTS, const std::atomic<bool> * = nullptr);
+    void advance_root(u_int, VIRTUAL_PIECE, uint64_t);
+    void accumulate_root_visits(std::vector<uint32_t> &);
+    u_int best_root_move();
+    std::pair<u_int, u_int> search(const FlatBoard &, uint64_t, VIRTUAL_PIECE, SearchBudget = SearchBudget());
+};
+
+// Function definitions
+
+TTStats cap_prior(TTStats);
+
+#endif
@@ -0,0 +1,46 @@
+#include "move_stream.h"
+
+// consts
+
+// a slot holds the sequence number above the three bytes of the move
+const u_int MOVE_BITS = 24;
+
+// packs a move and its sequence number into a slot word, sequence numbers start at 1 so an empty slot reads as 0
+static uint64_t pack_move(uint64_t sequence, const Move &move)
+{
+    return (sequence << MOVE_BITS) | (uint64_t(move.row) << 16) | (uint64_t(move.col) << 8) | static_cast<uint64_t>(move.piece);
+}
+
+// publishes a move, the slot is written before the count so a reader that sees the count also sees the move
+void MoveStream::update(const Move &move)
+{
+    uint64_t sequence = published.load(std::memory_order_relaxed);
+    slots[sequence % MOVE_STREAM_CAPACITY].store(pack_move(sequence + 1, move), std::memory_order_release);
+    published.store(sequence + 1, std::memory_order_release);
+}
+
+// reads the next move if one was published, a reader lapped by the producer moves on to the oldest move still kept
+bool MoveStreamReader::poll(Move &move)
+{
+    while (true)
+    {
+        uint64_t available = stream.published.load(std::memory_order_acquire);
+        if (next == available)
+            return false;
+
+        if (available - next > MOVE_STREAM_CAPACITY)
+        {
+            dropped += available - MOVE_STREAM_CAPACITY - next;
+            next = available - MOVE_STREAM_CAPACITY;
+        }
+
+        uint64_t slot = stream.slots[next % MOVE_STREAM_CAPACITY].load(std::memory_order_acquire);
+        if ((slot >> MOVE_BITS) == next + 1)
+        {
+            move = Move{static_cast<uint8_t>(slot >> 16), static_cast<uint8_t>(slot >> 8), static_cast<VIRTUAL_PIECE>(slot & 0xFF)};
+            next++;
+            return true;
+        }
+        // the slot was overwritten after the count was read, the next pass skips past it
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef MOVE_STREAM_H
+#define MOVE_STREAM_H
+
+#include "utils.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#define VIRTUAL_PIECE ID_ENUM
+
+// consts
+
+// moves a stream keeps, a reader further behind loses the oldest ones (power of two)
+const u_int MOVE_STREAM_CAPACITY = 1024;
+
+static_assert((MOVE_STREAM_CAPACITY & (MOVE_STREAM_CAPACITY - 1)) == 0, "stream capacity must be a power of two");
+
+// structs
+
+// move event delivered to every observer of a player
+struct Move
+{
+    uint8_t row;
+    uint8_t col;
+    VIRTUAL_PIECE piece;
+};
+
+// Receiver of the moves made by the players it is attached to
+class MoveObserver
+{
+public:
+    virtual ~MoveObserver() {}
+
+    virtual void update(const Move &) = 0;
+};
+
+/*
+ * Lock free single producer, multiple consumer broadcast ring of the moves of one game.
+ * Attached to both players it records every move (the players of a game move one at a time, so there is
+ * a single producer), and any number of MoveStreamReader cursors follow it at their own pace from other threads.
+ * Publishing never waits on the readers: one that falls more than MOVE_STREAM_CAPACITY moves behind
+ * skips the moves overwritten in the meantime.
+ */
+class MoveStream : public MoveObserver
+{
+    friend class MoveStreamReader;
+
+private:
+    // every slot packs a move with its sequence number + 1 in a single word, so a reader can never see a torn move
+    std::array<std::atomic<uint64_t>, MOVE_STREAM_CAPACITY> slots;
+    std::atomic<uint64_t> published;
+
+public:
+    MoveStream() : slots(), published(0) {}
+
+    void update(const Move &);
+    uint64_t size() const { return published.load(std::memory_order_acquire); }
+};
+
+// Cursor of a single consumer over a move stream, starting from the first move
+class MoveStreamReader
+{
+private:
+    const MoveStream &stream;
+    uint64_t next = 0;
+    uint64_t dropped = 0; // moves overwritten before this reader got to them
+
+public:
+    MoveStreamReader(const MoveStream &stream) : stream(stream) {}
+
+    bool poll(Move &);
+    uint64_t get_dropped() { return dropped; }
+};
+
+#endif
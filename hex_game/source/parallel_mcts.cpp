@@ -0,0 +1,264 @@
+#include "parallel_mcts.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+
+// picks the shared child maximising the UCT score, unvisited children first
+uint32_t ParallelMCTSEngine::select_shared_child(uint32_t node)
+{
+    const SharedMCTSNode &parent = shared_arena[node];
+    float log_visits = std::log(static_cast<float>(std::max(1, parent.visits.load(std::memory_order_relaxed))));
+
+    uint32_t best_child = parent.first_child;
+    float best_score = -1.0f;
+    for (uint32_t child = parent.first_child; child < parent.first_child + parent.child_count; child++)
+    {
+        int32_t visits = shared_arena[child].visits.load(std::memory_order_relaxed);
+        if (visits <= 0)
+            return child;
+
+        float score = shared_arena[child].wins.load(std::memory_order_relaxed) / static_cast<float>(visits) +
+                      MCTS_EXPLORATION * std::sqrt(log_visits / visits);
+        if (score > best_score)
+        {
+            best_score = score;
+            best_child = child;
+        }
+    }
+    return best_child;
+}
+
+// claims the node and appends one shared child per empty cell, returns false if another worker got there first
+// children of positions already in the transposition table start from their stored statistics
+bool ParallelMCTSEngine::expand_shared(uint32_t node, const FlatBoard &board, uint64_t hash, VIRTUAL_PIECE to_move,
+                                       std::vector<uint16_t> &empty_cells, Xoshiro256 &rng)
+{
+    NODE_STATE leaf = NODE_STATE::Leaf;
+    if (!shared_arena[node].state.compare_exchange_strong(leaf, NODE_STATE::Expanding, std::memory_order_acq_rel))
+        return false;
+
+    empty_cells.clear();
+    for (u_int i = 0; i < board.cell_count(); i++)
+        if (board[i] == VIRTUAL_PIECE::NOT_SET)
+            empty_cells.push_back(i);
+
+    uint32_t first_child = shared_arena_size.fetch_add(empty_cells.size(), std::memory_order_relaxed);
+    if (empty_cells.empty() || first_child + empty_cells.size() > MCTS_MAX_NODES)
+    {
+        shared_arena[node].state.store(NODE_STATE::Full, std::memory_order_release);
+        return false;
+    }
+
+    fast_shuffle(empty_cells.begin(), empty_cells.end(), rng);
+    for (u_int i = 0; i < empty_cells.size(); i++)
+    {
+        TTStats prior{0, 0};
+        if (transposition_table && transposition_table->probe(hash ^ zobrist_key(empty_cells[i], to_move), prior))
+            prior = cap_prior(prior);
+
+        SharedMCTSNode &child = shared_arena[first_child + i];
+        child.first_child = 0;
+        child.child_count = 0;
+        child.move = empty_cells[i];
+        child.visits.store(prior.visits, std::memory_order_relaxed);
+        child.wins.store(prior.wins, std::memory_order_relaxed);
+        child.state.store(NODE_STATE::Leaf, std::memory_order_relaxed);
+    }
+
+    shared_arena[node].first_child = first_child;
+    shared_arena[node].child_count = empty_cells.size();
+    shared_arena[node].state.store(NODE_STATE::Expanded, std::memory_order_release);
+    return true;
+}
+
+/*
+ * Worker body of the tree parallel search.
+ * Every node on the descent is charged MCTS_VIRTUAL_LOSS lost visits so concurrent workers spread over
+ * different lines, backpropagation then swaps the virtual losses for the real playout result.
+ */
+void ParallelMCTSEngine::grow_shared_tree(const FlatBoard &root_board, uint32_t root, uint64_t root_hash, VIRTUAL_PIECE p_id, const SearchClock &clock, std::atomic<u_int> &playouts_done, std::atomic<bool> &stop)
+{
+    FlatBoard board = root_board;
+    std::vector<uint32_t> path;
+    std::vector<uint16_t> empty_cells;
+    Xoshiro256 rng = make_worker_rng();
+    PlayoutKernel playout_kernel(playout_policy);
+
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        if (clock.expired(playouts_done.fetch_add(1, std::memory_order_relaxed)))
+        {
+            stop.store(true, std::memory_order_relaxed);
+            break;
+        }
+
+        board = root_board;
+        path.clear();
+
+        uint32_t node = root;
+        uint64_t hash = root_hash;
+        VIRTUAL_PIECE to_move = p_id;
+        shared_arena[node].visits.fetch_add(MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+        path.push_back(node);
+
+        while (shared_arena[node].state.load(std::memory_order_acquire) == NODE_STATE::Expanded)
+        {
+            node = select_shared_child(node);
+            shared_arena[node].visits.fetch_add(MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+            board[shared_arena[node].move] = to_move;
+            hash ^= zobrist_key(shared_arena[node].move, to_move);
+            to_move = opponent_of(to_move);
+            path.push_back(node);
+        }
+
+        if (shared_arena[node].visits.load(std::memory_order_relaxed) >= static_cast<int32_t>(MCTS_EXPANSION_THRESHOLD) &&
+            expand_shared(node, board, hash, to_move, empty_cells, rng))
+        {
+            node = shared_arena[node].first_child;
+            shared_arena[node].visits.fetch_add(MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+            board[shared_arena[node].move] = to_move;
+            to_move = opponent_of(to_move);
+            path.push_back(node);
+        }
+
+        playout_kernel.prepare(board);
+        VIRTUAL_PIECE winner = playout_kernel.run(to_move, rng);
+
+        VIRTUAL_PIECE mover = opponent_of(p_id);
+        for (uint32_t path_node : path)
+        {
+            shared_arena[path_node].visits.fetch_add(1 - MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+            if (mover == winner)
+                shared_arena[path_node].wins.fetch_add(1, std::memory_order_relaxed);
+            mover = opponent_of(mover);
+        }
+    }
+}
+
+// grows one independent tree per worker and returns the move with the most visits summed over all trees
+u_int ParallelMCTSEngine::root_parallel_search(const FlatBoard &root_board, uint64_t root_hash, VIRTUAL_PIECE p_id, SearchBudget budget)
+{
+    u_int workers = pool.get_size();
+    root_trees.resize(workers);
+    for (auto &tree : root_trees)
+    {
+        tree.set_transposition_table(transposition_table);
+        tree.set_playout_policy(playout_policy);
+    }
+
+    SearchBudget worker_budget = budget;
+    worker_budget.playouts = (budget.playouts + workers - 1) / workers;
+    u_int worker_default_playouts = (MCTS_PLAYOUTS + workers - 1) / workers;
+
+    std::vector<std::future<void>> results;
+    for (auto &tree : root_trees)
+        results.push_back(pool.submit([&tree, &root_board, root_hash, p_id, worker_budget, worker_default_playouts]()
+                                      { tree.grow(root_board, root_hash, p_id, worker_budget, worker_default_playouts); }));
+    for (auto &result : results)
+        result.get();
+
+    std::vector<uint32_t> visits_by_cell(root_board.cell_count(), 0);
+    for (auto &tree : root_trees)
+        tree.accumulate_root_visits(visits_by_cell);
+
+    return std::max_element(visits_by_cell.begin(), visits_by_cell.end()) - visits_by_cell.begin();
+}
+
+/*
+ * Grows a single tree shared by every worker and returns its most visited root move.
+ * The tree left by earlier searches is grown further when its root matches the position, nodes outside
+ * the current root's subtree are only reclaimed once half of the arena is used and the tree starts over.
+ * The root and its children are written back to the transposition table once the workers are done.
+ */
+u_int ParallelMCTSEngine::tree_parallel_search(const FlatBoard &root_board, uint64_t root_hash, VIRTUAL_PIECE p_id, SearchBudget budget)
+{
+    if (!shared_arena)
+        shared_arena.reset(new SharedMCTSNode[MCTS_MAX_NODES]);
+
+    const SearchClock clock(budget, MCTS_PLAYOUTS);
+    std::atomic<u_int> playouts_done(0);
+    std::atomic<bool> stop(false);
+
+    if (!shared_root_valid || tree_hash != root_hash ||
+        shared_arena[shared_root].state.load(std::memory_order_relaxed) == NODE_STATE::Full ||
+        shared_arena_size.load(std::memory_order_relaxed) > MCTS_MAX_NODES / 2)
+    {
+        SharedMCTSNode &root = shared_arena[0];
+        root.first_child = 0;
+        root.child_count = 0;
+        root.visits.store(MCTS_EXPANSION_THRESHOLD, std::memory_order_relaxed);
+        root.wins.store(0, std::memory_order_relaxed);
+        root.state.store(NODE_STATE::Leaf, std::memory_order_relaxed);
+        shared_arena_size.store(1, std::memory_order_relaxed);
+        shared_root = 0;
+        tree_hash = root_hash;
+    }
+    shared_root_valid = true;
+
+    const uint32_t root_node = shared_root;
+    SharedMCTSNode &root = shared_arena[root_node];
+    std::vector<uint16_t> empty_cells;
+    Xoshiro256 rng = make_worker_rng();
+    if (root.state.load(std::memory_order_relaxed) == NODE_STATE::Leaf)
+        expand_shared(root_node, root_board, root_hash, p_id, empty_cells, rng);
+    if (root.state.load(std::memory_order_relaxed) != NODE_STATE::Expanded)
+        throw UNDEFINED_BEHAVIOUR_ERROR;
+
+    std::vector<std::future<void>> results;
+    for (u_int i = 0; i < pool.get_size(); i++)
+        results.push_back(pool.submit([this, &root_board, root_node, root_hash, p_id, &clock, &playouts_done, &stop]()
+                                      { grow_shared_tree(root_board, root_node, root_hash, p_id, clock, playouts_done, stop); }));
+    for (auto &result : results)
+        result.get();
+
+    if (transposition_table)
+    {
+        auto stats_of = [this](uint32_t node)
+        { return TTStats{static_cast<uint32_t>(shared_arena[node].visits.load(std::memory_order_relaxed)),
+                         static_cast<uint32_t>(shared_arena[node].wins.load(std::memory_order_relaxed))}; };
+
+        transposition_table->store(root_hash, stats_of(root_node));
+        for (uint32_t child = root.first_child; child < root.first_child + root.child_count; child++)
+            if (shared_arena[child].visits.load(std::memory_order_relaxed) >= static_cast<int32_t>(MCTS_EXPANSION_THRESHOLD))
+                transposition_table->store(root_hash ^ zobrist_key(shared_arena[child].move, p_id), stats_of(child));
+    }
+
+    uint32_t best_child = root.first_child;
+    for (uint32_t child = root.first_child; child < root.first_child + root.child_count; child++)
+        if (shared_arena[child].visits.load(std::memory_order_relaxed) > shared_arena[best_child].visits.load(std::memory_order_relaxed))
+            best_child = child;
+    return shared_arena[best_child].move;
+}
+
+// moves the root of every tree down to the child reached by `piece` playing `cell`, `next_hash` is the board's hash after it
+// a shared root that does not match it is dropped so the next search starts over, this runs during a move broadcast and must not throw
+void ParallelMCTSEngine::advance_root(u_int cell, VIRTUAL_PIECE piece, uint64_t next_hash)
+{
+    for (auto &tree : root_trees)
+        tree.advance_root(cell, piece, next_hash);
+
+    if (!shared_root_valid)
+        return;
+
+    shared_root_valid = false;
+    const SharedMCTSNode &root = shared_arena[shared_root];
+    if (root.state.load(std::memory_order_relaxed) == NODE_STATE::Expanded)
+        for (uint32_t child = root.first_child; child < root.first_child + root.child_count; child++)
+            if (shared_arena[child].move == cell)
+            {
+                shared_root = child;
+                shared_root_valid = true;
+            }
+    tree_hash ^= zobrist_key(cell, piece);
+    if (tree_hash != next_hash)
+        shared_root_valid = false;
+}
+
+// searches the given position in the requested parallel mode
+std::pair<u_int, u_int> ParallelMCTSEngine::search(const FlatBoard &root_board, uint64_t root_hash, VIRTUAL_PIECE p_id, MCTS_MODE mode, SearchBudget budget)
+{
+    if (mode == MCTS_MODE::TreeParallel)
+        return root_board.coords(tree_parallel_search(root_board, root_hash, p_id, budget));
+    return root_board.coords(root_parallel_search(root_board, root_hash, p_id, budget));
+}
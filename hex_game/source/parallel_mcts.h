@@ -0,0 +1,79 @@
+#ifndef PARALLEL_MCTS_H
+#define PARALLEL_MCTS_H
+
+#include "utils.h"
+#include "flat_board.h"
+#include "mcts.h"
+#include "search_budget.h"
+#include "thread_pool.h"
+#include "rng.h"
+#include "playout.h"
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+#define VIRTUAL_PIECE ID_ENUM
+
+// consts
+
+// losses temporarily charged to a node while a worker's playout through it is in flight
+const int32_t MCTS_VIRTUAL_LOSS = 3;
+
+// enums
+
+enum class NODE_STATE : uint8_t
+{
+    Leaf,
+    Expanding,
+    Expanded,
+    Full, // expansion failed because the arena is full, stays a leaf
+};
+
+// structs
+
+// shared tree node, children are published by the expanding worker through `state`
+// and statistics are updated lock free by every worker
+struct SharedMCTSNode
+{
+    uint32_t first_child;
+    std::atomic<int32_t> visits; // includes the virtual losses of in-flight playouts
+    std::atomic<int32_t> wins;   // playouts won by the player who played `move`
+    uint16_t move;
+    uint16_t child_count;
+    std::atomic<NODE_STATE> state;
+};
+
+// Parallel UCT search running its workers on a shared thread pool
+class ParallelMCTSEngine
+{
+private:
+    ThreadPool &pool;
+    std::vector<MCTSEngine> root_trees;
+    std::unique_ptr<SharedMCTSNode[]> shared_arena;
+    std::atomic<uint32_t> shared_arena_size;
+    uint32_t shared_root = 0;       // arena index of the current root, moves down the tree as the game goes on
+    bool shared_root_valid = false; // false once the shared tree no longer matches the game
+    uint64_t tree_hash = 0;         // zobrist hash of the position at the shared root
+    TranspositionTable *transposition_table;
+    PLAYOUT_POLICY playout_policy = PLAYOUT_POLICY::Uniform;
+
+    uint32_t select_shared_child(uint32_t);
+    bool expand_shared(uint32_t, const FlatBoard &, uint64_t, VIRTUAL_PIECE, std::vector<uint16_t> &, Xoshiro256 &);
+    void grow_shared_tree(const FlatBoard &, uint32_t, uint64_t, VIRTUAL_PIECE, const SearchClock &, std::atomic<u_int> &, std::atomic<bool> &);
+
+    u_int root_parallel_search(const FlatBoard &, uint64_t, VIRTUAL_PIECE, SearchBudget);
+    u_int tree_parallel_search(const FlatBoard &, uint64_t, VIRTUAL_PIECE, SearchBudget);
+
+public:
+    ParallelMCTSEngine(ThreadPool &pool, TranspositionTable *transposition_table = nullptr)
+        : pool(pool), shared_arena_size(0), transposition_table(transposition_table) {}
+
+    void set_playout_policy(PLAYOUT_POLICY policy) { playout_policy = policy; }
+
+    std::pair<u_int, u_int> search(const FlatBoard &, uint64_t, VIRTUAL_PIECE, MCTS_MODE, SearchBudget = SearchBudget());
+    void advance_root(u_int, VIRTUAL_PIECE, uint64_t);
+};
+
+#endif
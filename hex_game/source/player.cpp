@@ -1,5 +1,6 @@
 #include "player.h"
 
+#include <algorithm>
 #include <cstdint>
 
 // return the player type (real or virtual)
@@ -14,19 +15,43 @@ PlayerType HexPlayerAI::get_player_type()
     return PlayerType::Virtual;
 }
 
-// asks the player to make a move
+// asks the player to make a move and notifies every attached board of it
 void HexPlayerABC::make_move(HexBoardABC *&board)
 {
     u_int move_row_id, move_col_id;
     get_player_move(move_row_id, move_col_id, board);
 
-    notify(board->get_board_type(), move_row_id, move_col_id, id);
+    notify(Move{static_cast<uint8_t>(move_row_id), static_cast<uint8_t>(move_col_id), id});
+}
+
+// makes the move then keeps searching while the opponent thinks (unless pondering is off)
+void HexPlayerMCTS::make_move(HexBoardABC *&board)
+{
+    HexPlayerABC::make_move(board);
+    if (ponder)
+        static_cast<HexBoardVirtual *>(board)->start_pondering(opponent_of(id));
 }
 
 // prompts the ai player to generate a move
 void HexPlayerAI::get_player_move(u_int &move_row_id, u_int &move_col_id, HexBoardABC *&board)
 {
-    std::pair<u_int, u_int> move = static_cast<HexBoardVirtual *>(board)->generate_move(id);
+    std::pair<u_int, u_int> move = static_cast<HexBoardVirtual *>(board)->generate_move(id, budget);
+    move_row_id = move.first;
+    move_col_id = move.second;
+}
+
+// prompts the mcts ai player to search for a move
+void HexPlayerMCTS::get_player_move(u_int &move_row_id, u_int &move_col_id, HexBoardABC *&board)
+{
+    std::pair<u_int, u_int> move = static_cast<HexBoardVirtual *>(board)->generate_mcts_move(id, budget, mode);
+    move_row_id = move.first;
+    move_col_id = move.second;
+}
+
+// prompts the resistance ai player for a move
+void HexPlayerResistance::get_player_move(u_int &move_row_id, u_int &move_col_id, HexBoardABC *&board)
+{
+    std::pair<u_int, u_int> move = static_cast<HexBoardVirtual *>(board)->generate_resistance_move(id);
     move_row_id = move.first;
     move_col_id = move.second;
 }
@@ -44,43 +69,49 @@ void HexPlayerHuman::get_player_move(u_int &move_row_id, u_int &move_col_id, Hex
     move_col_id = static_cast<HexBoardReal *>(board)->get_cell_by_str_id(cell_str_id).second;
 }
 
-// attach a board as an observer for the player
-void HexPlayerABC::attach(HexBoardABC *&target)
+// attach a board or move stream as an observer for the player, an observer already attached is left as is
+void HexPlayerABC::attach(MoveObserver *target)
 {
-    observers.emplace(target->get_board_type(), std::list<std::pair<const std::string, void *>>{{}});
-    observers.at(target->get_board_type()).remove(std::pair<const std::string, void *>{});
-
-    observers.at(target->get_board_type()).emplace_back(std::pair{std::to_string(reinterpret_cast<uintptr_t>(target)), target});
+    if (std::find(observers.begin(), observers.begin() + observer_count, target) != observers.begin() + observer_count)
+        return;
+    if (observer_count == MAX_OBSERVERS)
+        throw UNDEFINED_BEHAVIOUR_ERROR;
+    observers[observer_count++] = target;
 }
 
-// detaches a given board from the player's observers
-void HexPlayerABC::detach(HexBoardABC *&target)
+// detaches a given observer from the player, the others keep their order
+void HexPlayerABC::detach(MoveObserver *target)
 {
-    observers.at(target->get_board_type()).remove(std::pair{std::to_string(reinterpret_cast<uintptr_t>(target)), target});
+    auto end = std::remove(observers.begin(), observers.begin() + observer_count, target);
+    observer_count = end - observers.begin();
 }
 
-// notifies all observer boards of the given type
-void HexPlayerABC::notify(BoardType board_type, ...)
+// notifies all observers of the move, in the order they were attached
+void HexPlayerABC::notify(const Move &move)
 {
-    va_list args;
-    va_start(args, OBSERVER_TYPE_CAST_DISPATCHER.at(board_type).first);
-    for (auto target : observers.at(board_type))
-    {
-        OBSERVER_TYPE_CAST_DISPATCHER.at(board_type).second(target.second, args);
-    }
+    for (u_int i = 0; i < observer_count; i++)
+        observers[i]->update(move);
 }
 
 // player factory method
-HexPlayerABC *HexPlayerFactory::make(PLAYER_ID id, bool ai_switch)
+HexPlayerABC *HexPlayerFactory::make(PLAYER_ID id, bool ai_switch, AI_ENGINE engine, SearchBudget budget, bool ponder)
 {
+    if (ai_switch && engine == AI_ENGINE::MCTS)
+        return new HexPlayerMCTS(id, budget, MCTS_MODE::Serial, ponder);
+    if (ai_switch && engine == AI_ENGINE::MCTSRootParallel)
+        return new HexPlayerMCTS(id, budget, MCTS_MODE::RootParallel, ponder);
+    if (ai_switch && engine == AI_ENGINE::MCTSTreeParallel)
+        return new HexPlayerMCTS(id, budget, MCTS_MODE::TreeParallel, ponder);
+    if (ai_switch && engine == AI_ENGINE::Resistance)
+        return new HexPlayerResistance(id);
     if (ai_switch)
-        return new HexPlayerAI(id);
+        return new HexPlayerAI(id, budget);
     return new HexPlayerHuman(id);
 }
 
 // factory generating two opposing players
-void HexPlayerFactory::init_players(HexPlayerABC *&p1, HexPlayerABC *&p2, bool ai_switch, bool colour_switch)
+void HexPlayerFactory::init_players(HexPlayerABC *&p1, HexPlayerABC *&p2, bool ai_switch, bool colour_switch, AI_ENGINE engine, SearchBudget budget)
 {
-    p1 = HexPlayerFactory::make(PLAYER_ID::P1, ai_switch && colour_switch);
-    p2 = HexPlayerFactory::make(PLAYER_ID::P2, ai_switch && !colour_switch);
+    p1 = HexPlayerFactory::make(PLAYER_ID::P1, ai_switch && colour_switch, engine, budget);
+    p2 = HexPlayerFactory::make(PLAYER_ID::P2, ai_switch && !colour_switch, engine, budget);
 }
@@ -4,11 +4,9 @@
 #include "utils.h"
 #include "hex_board.h"
 
-#include <list>
+#include <array>
 #include <unordered_map>
 #include <string>
-#include <map>
-#include <functional>
 
 #define PLAYER_ID ID_ENUM
 #define PlayerType REAL_VIRTUAL
@@ -39,6 +37,9 @@ const std::unordered_map<PLAYER_ID, PIECE> PLAYER_PIECE =
         {PLAYER_ID::P2, PIECE::P2},
 };
 
+// most observers (boards and move streams) a single player can notify
+const u_int MAX_OBSERVERS = 8;
+
 const std::unordered_map<PLAYER_ID, Colour> PLAYER_COLOUR =
     {
         {PLAYER_ID::NOT_SET, Colour{WHITE, "white"}},
@@ -53,15 +54,8 @@ protected:
     const Colour colour;
     const PLAYER_ID id;
     const PIECE piece;
-    std::map<const BoardType, std::list<std::pair<const std::string, void *>>> observers;
-
-    const std::map<const BoardType, std::pair<const int, std::function<void(void *&, va_list)>>> OBSERVER_TYPE_CAST_DISPATCHER =
-        {
-            {BoardType::Real, {3, [](void *&pntr_to_cast, va_list args) -> void
-                               { static_cast<HexBoardReal *>(pntr_to_cast)->update(args); }}},
-            {BoardType::Virtual, {3, [](void *&pntr_to_cast, va_list args) -> void
-                                  { static_cast<HexBoardVirtual *>(pntr_to_cast)->update(args); }}},
-    };
+    std::array<MoveObserver *, MAX_OBSERVERS> observers{}; // in attach order, the first observer_count are set
+    u_int observer_count = 0;
 
 public:
     HexPlayerABC() : id(PLAYER_ID::NOT_SET), piece(PIECE::NOT_SET), colour(Colour{"NOT_SET", "NOT_SET"}) {}
@@ -72,9 +66,9 @@ public:
     virtual void get_player_move(u_int &, u_int &, HexBoardABC *&) = 0;
     virtual PlayerType get_player_type() = 0;
     virtual void make_move(HexBoardABC *&);
-    virtual void attach(HexBoardABC *&);
-    virtual void detach(HexBoardABC *&);
-    virtual void notify(BoardType, ...);
+    virtual void attach(MoveObserver *);
+    virtual void detach(MoveObserver *);
+    virtual void notify(const Move &);
 
     PLAYER_ID get_id() { return id; }
 };
@@ -84,14 +78,45 @@ class HexPlayerAI : public HexPlayerABC
 {
 private:
 protected:
+    const SearchBudget budget;
+
 public:
-    HexPlayerAI(PLAYER_ID id) : HexPlayerABC(id) {}
+    HexPlayerAI(PLAYER_ID id, SearchBudget budget = SearchBudget()) : HexPlayerABC(id), budget(budget) {}
     ~HexPlayerAI() {}
 
     void get_player_move(u_int &, u_int &, HexBoardABC *&);
     PlayerType get_player_type();
 };
 
+// AI player class searching with monte carlo tree search
+class HexPlayerMCTS : public HexPlayerAI
+{
+private:
+protected:
+    const MCTS_MODE mode;
+    const bool ponder;
+
+public:
+    HexPlayerMCTS(PLAYER_ID id, SearchBudget budget = SearchBudget(), MCTS_MODE mode = MCTS_MODE::Serial, bool ponder = true)
+        : HexPlayerAI(id, budget), mode(mode), ponder(ponder) {}
+    ~HexPlayerMCTS() {}
+
+    void get_player_move(u_int &, u_int &, HexBoardABC *&);
+    void make_move(HexBoardABC *&);
+};
+
+// AI player class playing the move the resistance evaluator rates best, ignores the search budget
+class HexPlayerResistance : public HexPlayerAI
+{
+private:
+protected:
+public:
+    HexPlayerResistance(PLAYER_ID id) : HexPlayerAI(id) {}
+    ~HexPlayerResistance() {}
+
+    void get_player_move(u_int &, u_int &, HexBoardABC *&);
+};
+
 // Human player class
 class HexPlayerHuman : public HexPlayerABC
 {
@@ -108,7 +133,7 @@ public:
 class HexPlayerFactory
 {
 public:
-    static HexPlayerABC *make(PLAYER_ID, bool);
-    static void init_players(HexPlayerABC *&, HexPlayerABC *&, bool, bool);
+    static HexPlayerABC *make(PLAYER_ID, bool, AI_ENGINE = AI_ENGINE::MonteCarlo, SearchBudget = SearchBudget(), bool = true);
+    static void init_players(HexPlayerABC *&, HexPlayerABC *&, bool, bool, AI_ENGINE = AI_ENGINE::MonteCarlo, SearchBudget = SearchBudget());
 };
 #endif
@@ -0,0 +1,136 @@
+#include "playout.h"
+
+// lists the neighbours of every cell on a board of the given size in ring order
+BridgeTable::BridgeTable(u_int size) : rows(size * size)
+{
+    const NeighbourTable &neighbours = NeighbourTable::for_size(size);
+    for (u_int idx = 0; idx < size * size; idx++)
+        for (u_int k = 0; k < NEIGHBOUR_COUNT; k++)
+        {
+            int16_t neighbour = neighbours[idx][static_cast<int>(NEIGHBOUR_RING[k])];
+            rows[idx][k] = neighbour == NO_NEIGHBOUR ? OFF_BOARD_CELL : neighbour;
+        }
+}
+
+// returns the shared bridge table of the given size, every size up to MAX_BOARD_SIZE is built on first use
+const BridgeTable &BridgeTable::for_size(u_int size)
+{
+    static const std::vector<BridgeTable> tables = []()
+    {
+        std::vector<BridgeTable> tables;
+        for (u_int size = 0; size <= MAX_BOARD_SIZE; size++)
+            tables.push_back(BridgeTable(size));
+        return tables;
+    }();
+
+    if (size > MAX_BOARD_SIZE)
+        throw UNDEFINED_BEHAVIOUR_ERROR;
+    return tables[size];
+}
+
+// snapshots the position and its empty cells as the starting point of the following runs
+void PlayoutKernel::prepare(const FlatBoard &position)
+{
+    base_board = HexBitBoard(position);
+    empty_count = 0;
+
+    for (u_int i = 0; i < position.cell_count(); i++)
+        if (position[i] == VIRTUAL_PIECE::NOT_SET)
+        {
+            std::pair<u_int, u_int> coords = position.coords(i);
+            empty_cells[empty_count++] = (coords.first << 8) | coords.second;
+        }
+
+    if (policy != PLAYOUT_POLICY::Bridge)
+        return;
+
+    bridges = &BridgeTable::for_size(position.get_size());
+    cell_count = position.cell_count();
+    base_cells[OFF_BOARD_CELL] = OFF_BOARD_STATE;
+    cells[OFF_BOARD_CELL] = OFF_BOARD_STATE;
+    for (u_int i = 0, empty = 0; i < cell_count; i++)
+    {
+        std::pair<u_int, u_int> coords = position.coords(i);
+        base_cells[i] = static_cast<uint8_t>(position[i]);
+        cell_coords[i] = (coords.first << 8) | coords.second;
+        if (position[i] == VIRTUAL_PIECE::NOT_SET)
+        {
+            empty_idx[empty] = i;
+            slot_of[i] = empty++;
+        }
+    }
+}
+
+/*
+ * Plays the prepared position out at random, alternating from `to_move`, and returns the winner.
+ * The empty cells are shuffled in place (Fisher-Yates) in the same pass that places the stones,
+ * and the filled board is decided by a single bitboard flood fill.
+ */
+VIRTUAL_PIECE PlayoutKernel::run_uniform(VIRTUAL_PIECE to_move, Xoshiro256 &rng)
+{
+    board = base_board;
+
+    for (u_int i = 0; i < empty_count; i++)
+    {
+        std::swap(empty_cells[i], empty_cells[i + rng.bounded(empty_count - i)]);
+        board.set(empty_cells[i] >> 8, empty_cells[i] & 0xFF, to_move);
+        to_move = opponent_of(to_move);
+    }
+
+    // the board is full so exactly one player is connected
+    return board.player_connected(VIRTUAL_PIECE::P1) ? VIRTUAL_PIECE::P1 : VIRTUAL_PIECE::P2;
+}
+
+// rotates a ring of six bits so bit k takes the value of bit k + shift
+static uint32_t rotate_ring(uint32_t ring, u_int shift)
+{
+    return ((ring >> shift) | (ring << (NEIGHBOUR_COUNT - shift))) & ((1u << NEIGHBOUR_COUNT) - 1);
+}
+
+/*
+ * Same as run_uniform, except that when the last stone was played into one of the carriers of a two-bridge
+ * of the player to move, the player saves the bridge by taking the other carrier instead of a random cell.
+ * The six neighbours of the last stone are read into an own and an empty ring mask and every bridge around it
+ * is checked at once with two rotations, so each step is O(1) and branch free until a bridge is found.
+ * The shuffle keeps slot_of in step with empty_idx, so the chosen carrier can be swapped into place directly.
+ */
+VIRTUAL_PIECE PlayoutKernel::run_bridge(VIRTUAL_PIECE to_move, Xoshiro256 &rng)
+{
+    board = base_board;
+    std::copy_n(base_cells.begin(), cell_count, cells.begin());
+    u_int last_cell = OFF_BOARD_CELL;
+
+    for (u_int i = 0; i < empty_count; i++)
+    {
+        u_int pick = empty_count; // no bridge to save
+        if (last_cell != OFF_BOARD_CELL)
+        {
+            const BridgeRow &ring = (*bridges)[last_cell];
+            uint32_t own = 0, empty = 0;
+            for (u_int k = 0; k < NEIGHBOUR_COUNT; k++)
+            {
+                own |= uint32_t(cells[ring[k]] == static_cast<uint8_t>(to_move)) << k;
+                empty |= uint32_t(cells[ring[k]] == static_cast<uint8_t>(VIRTUAL_PIECE::NOT_SET)) << k;
+            }
+
+            // bit k is set when ring neighbours k and k + 2 are own stones and k + 1 is still empty
+            uint32_t intruded = own & rotate_ring(own, 2) & rotate_ring(empty, 1);
+            if (intruded)
+                pick = slot_of[ring[(__builtin_ctz(intruded) + 1) % NEIGHBOUR_COUNT]];
+        }
+        if (pick == empty_count)
+            pick = i + rng.bounded(empty_count - i);
+
+        std::swap(empty_idx[i], empty_idx[pick]);
+        slot_of[empty_idx[i]] = i;
+        slot_of[empty_idx[pick]] = pick;
+
+        last_cell = empty_idx[i];
+        cells[last_cell] = static_cast<uint8_t>(to_move);
+        board.set(cell_coords[last_cell] >> 8, cell_coords[last_cell] & 0xFF, to_move);
+        to_move = opponent_of(to_move);
+    }
+
+    // the board is full so exactly one player is connected
+    return board.player_connected(VIRTUAL_PIECE::P1) ? VIRTUAL_PIECE::P1 : VIRTUAL_PIECE::P2;
+}
@@ -0,0 +1,96 @@
+#ifndef PLAYOUT_H
+#define PLAYOUT_H
+
+#include "utils.h"
+#include "flat_board.h"
+#include "bitboard.h"
+#include "rng.h"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#define VIRTUAL_PIECE ID_ENUM
+
+// consts
+
+// neighbour directions in order around a cell, two directions next to each other lead to adjacent cells
+const std::array<NEIGHBOUR, NEIGHBOUR_COUNT> NEIGHBOUR_RING =
+    {
+        NEIGHBOUR::UP_LEFT,
+        NEIGHBOUR::UP_RIGHT,
+        NEIGHBOUR::ROW_RIGHT,
+        NEIGHBOUR::DOWN_RIGHT,
+        NEIGHBOUR::DOWN_LEFT,
+        NEIGHBOUR::ROW_LEFT,
+};
+
+// enums
+
+enum class PLAYOUT_POLICY
+{
+    Uniform, // every empty cell equally likely at every step
+    Bridge,  // uniform, except that an intrusion into one of the mover's two-bridges is answered at once
+};
+
+// flat index standing in for the neighbours off the board, its cell never holds a stone or is empty
+const uint16_t OFF_BOARD_CELL = MAX_BOARD_CELLS;
+const uint8_t OFF_BOARD_STATE = 3;
+
+// typedefs
+
+// neighbours of a cell in NEIGHBOUR_RING order, OFF_BOARD_CELL past the edges
+typedef std::array<uint16_t, NEIGHBOUR_COUNT> BridgeRow;
+
+// Precomputed two-bridge patterns of every cell of a given board size
+// (built once per size and shared by every playout kernel of that size)
+// A cell is a carrier of the bridge between ring neighbours k and k + 2, neighbour k + 1 is the other carrier
+class BridgeTable
+{
+private:
+    std::vector<BridgeRow> rows;
+
+    BridgeTable(u_int);
+
+public:
+    static const BridgeTable &for_size(u_int);
+
+    const BridgeRow &operator[](u_int idx) const { return rows[idx]; }
+};
+
+// Random playout kernel with preallocated scratch buffers, owned by a single worker
+// prepare() snapshots a position once, run() then plays it out any number of times without allocating
+class PlayoutKernel
+{
+private:
+    PLAYOUT_POLICY policy;
+    HexBitBoard base_board;
+    HexBitBoard board;
+    std::array<uint16_t, MAX_BOARD_CELLS> empty_cells; // row in the high byte, column in the low byte
+    u_int empty_count = 0;
+
+    // bridge policy state, cells are flat indices so the pattern tables can be followed
+    const BridgeTable *bridges = nullptr;
+    std::array<uint8_t, MAX_BOARD_CELLS + 1> base_cells; // VIRTUAL_PIECE per cell, OFF_BOARD_STATE at OFF_BOARD_CELL
+    std::array<uint8_t, MAX_BOARD_CELLS + 1> cells;
+    std::array<uint16_t, MAX_BOARD_CELLS> empty_idx;
+    std::array<uint16_t, MAX_BOARD_CELLS> slot_of;     // position of every empty cell in empty_idx
+    std::array<uint16_t, MAX_BOARD_CELLS> cell_coords; // row in the high byte, column in the low byte
+    u_int cell_count = 0;
+
+    VIRTUAL_PIECE run_uniform(VIRTUAL_PIECE, Xoshiro256 &);
+    VIRTUAL_PIECE run_bridge(VIRTUAL_PIECE, Xoshiro256 &);
+
+public:
+    PlayoutKernel(PLAYOUT_POLICY policy = PLAYOUT_POLICY::Uniform) : policy(policy), base_board(0), board(0) {}
+
+    void set_policy(PLAYOUT_POLICY new_policy) { policy = new_policy; }
+
+    void prepare(const FlatBoard &);
+    VIRTUAL_PIECE run(VIRTUAL_PIECE to_move, Xoshiro256 &rng)
+    {
+        return policy == PLAYOUT_POLICY::Bridge ? run_bridge(to_move, rng) : run_uniform(to_move, rng);
+    }
+};
+
+#endif
@@ -0,0 +1,285 @@
+#include "resistance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// breadth first distance of every cell from one edge of a player over the empty board (edge bit 1 for the first,
+// 2 for the second), the edge cells are at distance 1
+static std::array<u_int, MAX_BOARD_CELLS> edge_distance(u_int cell_count, const NeighbourTable &neighbours, const EdgeTable &edges,
+                                                        VIRTUAL_PIECE p_id, uint8_t edge)
+{
+    std::array<u_int, MAX_BOARD_CELLS> distance;
+    distance.fill(0);
+    std::vector<u_int> queue;
+    for (u_int cell = 0; cell < cell_count; cell++)
+        if (edges(cell, p_id) & edge)
+        {
+            distance[cell] = 1;
+            queue.push_back(cell);
+        }
+
+    for (u_int i = 0; i < queue.size(); i++)
+        for (int16_t next : neighbours[queue[i]])
+            if (next != NO_NEIGHBOUR && !distance[next])
+            {
+                distance[next] = distance[queue[i]] + 1;
+                queue.push_back(next);
+            }
+    return distance;
+}
+
+// lays out the starting voltages of each player, the same for every position of this size
+ResistanceEvaluator::ResistanceEvaluator(u_int size)
+    : size(size), cell_count(size * size), relaxation(2.0 / (1.0 + RESISTANCE_RELAXATION_SCALE / std::max<u_int>(size, 1))),
+      neighbours(&NeighbourTable::for_size(size)), edges(&EdgeTable::for_size(size))
+{
+    for (VIRTUAL_PIECE p_id : {VIRTUAL_PIECE::P1, VIRTUAL_PIECE::P2})
+    {
+        u_int slot = player_slot(p_id);
+        std::array<u_int, MAX_BOARD_CELLS> from_first = edge_distance(cell_count, *neighbours, *edges, p_id, 1);
+        std::array<u_int, MAX_BOARD_CELLS> from_second = edge_distance(cell_count, *neighbours, *edges, p_id, 2);
+        for (u_int idx = 0; idx < cell_count; idx++)
+            ramp[slot][idx] = static_cast<double>(from_second[idx]) / (from_first[idx] + from_second[idx]);
+    }
+    flow.fill(0.0);
+}
+
+// returns the root of the union find group holding the given cell or edge, halving the path on the way
+uint16_t ResistanceEvaluator::find_group(uint16_t node)
+{
+    while (group[node] != node)
+    {
+        group[node] = group[group[node]];
+        node = group[node];
+    }
+    return node;
+}
+
+/*
+ * Builds the given player's network for the position: the player's groups and the edges they touch are merged
+ * with a union find, every remaining group and empty cell is numbered as a node after the two edge nodes,
+ * then the links are counted and laid out per node in two passes over the cells.
+ */
+void ResistanceEvaluator::build(const FlatBoard &board, VIRTUAL_PIECE p_id)
+{
+    ResistanceNetwork &network = networks[player_slot(p_id)];
+    const uint16_t source_group = cell_count, sink_group = cell_count + 1;
+
+    for (u_int i = 0; i < cell_count + 2; i++)
+        group[i] = i;
+    for (u_int idx = 0; idx < cell_count; idx++)
+    {
+        if (board[idx] != p_id)
+            continue;
+        if ((*edges)(idx, p_id) & 1)
+            group[find_group(idx)] = find_group(source_group);
+        if ((*edges)(idx, p_id) & 2)
+            group[find_group(idx)] = find_group(sink_group);
+        for (int16_t next : (*neighbours)[idx])
+            if (next != NO_NEIGHBOUR && board[next] == p_id)
+                group[find_group(idx)] = find_group(next);
+    }
+
+    network.connected = find_group(source_group) == find_group(sink_group);
+    if (network.connected)
+        return;
+
+    std::fill_n(node_id.begin(), cell_count + 2, NO_NODE);
+    node_id[find_group(source_group)] = SOURCE_NODE;
+    node_id[find_group(sink_group)] = SINK_NODE;
+    network.node_count = 2;
+    for (u_int idx = 0; idx < cell_count; idx++)
+    {
+        network.node_of[idx] = NO_NODE;
+        if (board[idx] == opponent_of(p_id))
+            continue;
+        uint16_t root = find_group(idx);
+        if (node_id[root] == NO_NODE)
+            node_id[root] = network.node_count++;
+        network.node_of[idx] = node_id[root];
+    }
+
+    // calls visit(from, to, conductance) for every directed link, a link between two nodes joined by several
+    // pairs of cells is listed once per pair, which sums their conductances
+    auto for_each_link = [&](auto &&visit)
+    {
+        for (u_int idx = 0; idx < cell_count; idx++)
+        {
+            int16_t node = network.node_of[idx];
+            if (node == NO_NODE)
+                continue;
+
+            double resistance = board[idx] == p_id ? 0.0 : 1.0;
+            for (int16_t next : (*neighbours)[idx])
+                if (next != NO_NEIGHBOUR && network.node_of[next] != NO_NODE && network.node_of[next] != node)
+                    visit(node, network.node_of[next], 1.0 / (resistance + (board[next] == p_id ? 0.0 : 1.0)));
+
+            // a stone on an edge is part of the edge node, so only empty cells link to the edges
+            if (((*edges)(idx, p_id) & 1) && node != SOURCE_NODE)
+            {
+                visit(node, SOURCE_NODE, 1.0 / resistance);
+                visit(SOURCE_NODE, node, 1.0 / resistance);
+            }
+            if (((*edges)(idx, p_id) & 2) && node != SINK_NODE)
+            {
+                visit(node, SINK_NODE, 1.0 / resistance);
+                visit(SINK_NODE, node, 1.0 / resistance);
+            }
+        }
+    };
+
+    // links of node k are counted in first_link[k + 2] (up to MAX_NETWORK_NODES + 1), the prefix sum moves the
+    // start of every node to first_link[k + 1] and laying the links out advances it to the start of node k + 1
+    std::fill_n(network.first_link.begin(), network.node_count + 2, 0);
+    for_each_link([&](int16_t from, int16_t, double)
+                  { network.first_link[from + 2]++; });
+    for (u_int node = 2; node < network.node_count + 2; node++)
+        network.first_link[node] += network.first_link[node - 1];
+    for_each_link([&](int16_t from, int16_t to, double conductance)
+                  {
+                      uint16_t link = network.first_link[from + 1]++;
+                      network.link_node[link] = to;
+                      network.link_conductance[link] = conductance; });
+
+    for (u_int node = 0; node < network.node_count; node++)
+    {
+        double total = 0.0;
+        for (u_int link = network.first_link[node]; link < network.first_link[node + 1]; link++)
+            total += network.link_conductance[link];
+        network.inverse_total[node] = total > 0.0 ? 1.0 / total : 0.0;
+    }
+}
+
+/*
+ * Gauss-Seidel sweeps with over-relaxation from the given cell voltages: every node moves past the weighted mean
+ * of its neighbours' voltages until the largest move of a sweep falls under RESISTANCE_TOLERANCE,
+ * then the current drawn from the source gives the conductance of the network.
+ */
+void ResistanceEvaluator::relax(ResistanceNetwork &network, const std::array<double, MAX_BOARD_CELLS> &start)
+{
+    network.voltage[SOURCE_NODE] = 1.0;
+    network.voltage[SINK_NODE] = 0.0;
+    for (u_int idx = 0; idx < cell_count; idx++)
+        if (network.node_of[idx] > SINK_NODE)
+            network.voltage[network.node_of[idx]] = start[idx];
+
+    for (u_int sweep = 0; sweep < RESISTANCE_MAX_SWEEPS; sweep++)
+    {
+        double largest_step = 0.0;
+        for (u_int node = SINK_NODE + 1; node < network.node_count; node++)
+        {
+            double inflow = 0.0;
+            for (u_int link = network.first_link[node]; link < network.first_link[node + 1]; link++)
+                inflow += network.link_conductance[link] * network.voltage[network.link_node[link]];
+
+            double step = relaxation * (inflow * network.inverse_total[node] - network.voltage[node]);
+            network.voltage[node] += step;
+            largest_step = std::max(largest_step, std::fabs(step));
+        }
+        if (largest_step < RESISTANCE_TOLERANCE)
+            break;
+    }
+
+    network.conductance = 0.0;
+    for (u_int link = network.first_link[SOURCE_NODE]; link < network.first_link[SOURCE_NODE + 1]; link++)
+        network.conductance += network.link_conductance[link] * (1.0 - network.voltage[network.link_node[link]]);
+    network.conductance = std::max(network.conductance, RESISTANCE_MIN_CONDUCTANCE);
+}
+
+// builds and solves the given player's network, a player already joining their edges needs no solve
+void ResistanceEvaluator::solve_network(const FlatBoard &board, VIRTUAL_PIECE p_id, const std::array<double, MAX_BOARD_CELLS> &start)
+{
+    ResistanceNetwork &network = networks[player_slot(p_id)];
+    build(board, p_id);
+    if (network.connected)
+        network.conductance = RESISTANCE_MAX_CONDUCTANCE;
+    else
+        relax(network, start);
+}
+
+// current through a cell, half the current on all of its links since what flows in flows out
+double ResistanceEvaluator::cell_current(const ResistanceNetwork &network, u_int idx) const
+{
+    int16_t node = network.node_of[idx];
+    if (network.connected || node == NO_NODE)
+        return 0.0;
+
+    double current = 0.0;
+    for (u_int link = network.first_link[node]; link < network.first_link[node + 1]; link++)
+        current += network.link_conductance[link] * std::fabs(network.voltage[node] - network.voltage[network.link_node[link]]);
+    return current / 2;
+}
+
+// solves both networks of the position and the current through every empty cell, relative to each network's total
+void ResistanceEvaluator::solve(const FlatBoard &board)
+{
+    for (VIRTUAL_PIECE p_id : {VIRTUAL_PIECE::P1, VIRTUAL_PIECE::P2})
+        solve_network(board, p_id, ramp[player_slot(p_id)]);
+
+    for (u_int idx = 0; idx < cell_count; idx++)
+    {
+        flow[idx] = 0.0;
+        if (board[idx] != VIRTUAL_PIECE::NOT_SET)
+            continue;
+        for (const ResistanceNetwork &network : networks)
+            if (network.conductance > RESISTANCE_MIN_CONDUCTANCE)
+                flow[idx] += cell_current(network, idx) / network.conductance;
+    }
+}
+
+// share of the total conductance held by the given player in the last solved position, in (0, 1)
+double ResistanceEvaluator::value(VIRTUAL_PIECE p_id) const
+{
+    double own = get_conductance(p_id), other = get_conductance(opponent_of(p_id));
+    return own / (own + other);
+}
+
+// solves the position and returns its value for the given player
+double ResistanceEvaluator::evaluate(const FlatBoard &board, VIRTUAL_PIECE p_id)
+{
+    solve(board);
+    return value(p_id);
+}
+
+/*
+ * One ply search: plays every empty cell in turn and returns the one leaving the given player the best value.
+ * Each reply is solved starting from the voltages of the current position, which a single stone barely moves,
+ * so the whole search costs about as much as a few cold solves per cell.
+ */
+u_int ResistanceEvaluator::best_move(const FlatBoard &root_board, VIRTUAL_PIECE p_id)
+{
+    solve(root_board);
+    std::array<std::array<double, MAX_BOARD_CELLS>, 2> root_voltage = ramp;
+    for (u_int slot = 0; slot < 2; slot++)
+        if (!networks[slot].connected)
+            for (u_int idx = 0; idx < cell_count; idx++)
+                if (networks[slot].node_of[idx] != NO_NODE)
+                    root_voltage[slot][idx] = networks[slot].voltage[networks[slot].node_of[idx]];
+
+    FlatBoard board = root_board;
+    u_int best_idx = cell_count;
+    double best_value = -1.0;
+    for (u_int idx = 0; idx < cell_count; idx++)
+    {
+        if (board[idx] != VIRTUAL_PIECE::NOT_SET)
+            continue;
+
+        board[idx] = p_id;
+        for (VIRTUAL_PIECE player : {VIRTUAL_PIECE::P1, VIRTUAL_PIECE::P2})
+            solve_network(board, player, root_voltage[player_slot(player)]);
+        board[idx] = VIRTUAL_PIECE::NOT_SET;
+
+        // ties go to the cell carrying the most current in the current position
+        double move_value = value(p_id);
+        if (move_value > best_value || (move_value == best_value && flow[idx] > flow[best_idx]))
+        {
+            best_value = move_value;
+            best_idx = idx;
+        }
+    }
+
+    if (best_idx == cell_count)
+        throw UNDEFINED_BEHAVIOUR_ERROR;
+    return best_idx;
+}
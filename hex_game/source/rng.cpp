@@ -0,0 +1,47 @@
+#include "rng.h"
+
+#include <atomic>
+#include <random>
+
+// master seed every worker stream is derived from, random unless set explicitly
+static std::atomic<uint64_t> master_seed((static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}());
+
+// number of worker streams handed out so far
+static std::atomic<uint64_t> worker_streams(0);
+
+// splitmix64 step from: https://prng.di.unimi.it/splitmix64.c
+uint64_t splitmix64(uint64_t &x)
+{
+    uint64_t z = (x += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+// seeds the generator state from a single 64 bit value
+Xoshiro256::Xoshiro256(uint64_t seed)
+{
+    for (int i = 0; i < 4; i++)
+        state[i] = splitmix64(seed);
+}
+
+// sets the master seed and restarts the worker stream numbering, used for reproducible runs
+void set_master_seed(uint64_t seed)
+{
+    master_seed.store(seed);
+    worker_streams.store(0);
+}
+
+// returns the current master seed
+uint64_t get_master_seed()
+{
+    return master_seed.load();
+}
+
+// returns a generator on a stream of its own, no two calls share a stream for a given master seed
+Xoshiro256 make_worker_rng()
+{
+    uint64_t stream = worker_streams.fetch_add(1);
+    uint64_t stream_seed = master_seed.load() ^ (stream * 0xd1342543de82ef95);
+    return Xoshiro256(splitmix64(stream_seed));
+}
@@ -0,0 +1,63 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include "utils.h"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+// xoshiro256** generator from: https://prng.di.unimi.it/xoshiro256starstar.c
+// small, fast and not thread safe by design, every worker owns its own instance
+class Xoshiro256
+{
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    typedef uint64_t result_type;
+
+    Xoshiro256(uint64_t);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()()
+    {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+
+        return result;
+    }
+
+    // uniform value in [0, bound) using Lemire's multiply-shift reduction
+    uint32_t bounded(uint32_t bound) { return static_cast<uint32_t>(((*this)() >> 32) * bound >> 32); }
+};
+
+// Function definitions
+
+uint64_t splitmix64(uint64_t &);
+void set_master_seed(uint64_t);
+uint64_t get_master_seed();
+Xoshiro256 make_worker_rng();
+
+// Template implementations
+
+// Fisher-Yates shuffle drawing from a worker generator
+template <class RandomIt>
+void fast_shuffle(RandomIt first, RandomIt last, Xoshiro256 &rng)
+{
+    for (uint32_t i = last - first; i > 1; i--)
+        std::swap(first[i - 1], first[rng.bounded(i)]);
+}
+
+#endif
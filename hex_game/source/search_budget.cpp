@@ -0,0 +1,41 @@
+#include "search_budget.h"
+
+#include <algorithm>
+#include <limits>
+
+// returns the time limit of a budget, an empty budget gets the default think time
+static u_int time_limit_ms(SearchBudget budget)
+{
+    return (budget.playouts || budget.time_ms) ? budget.time_ms : DEFAULT_SEARCH_TIME_MS;
+}
+
+// starts the clock, `default_playouts` applies when the budget sets no limit at all
+SearchClock::SearchClock(SearchBudget budget, u_int default_playouts)
+    : deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(time_limit_ms(budget))),
+      timed(time_limit_ms(budget) != 0),
+      playout_limit((budget.playouts || budget.time_ms) ? budget.playouts : default_playouts) {}
+
+// returns how many playouts are left, unbounded searches report the max value
+u_int SearchClock::remaining_playouts(u_int done) const
+{
+    if (!playout_limit)
+        return std::numeric_limits<u_int>::max();
+    return (done < playout_limit) ? playout_limit - done : 0;
+}
+
+// returns the milliseconds left before the deadline rounded up, untimed searches report the max value
+// (a clock read right after it started still reports its whole time limit)
+u_int SearchClock::remaining_ms() const
+{
+    if (!timed)
+        return std::numeric_limits<u_int>::max();
+    auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+    return left > 0 ? left : 0;
+}
+
+// returns the budget left to a search started after other work on this clock, with the default playout count
+// filled in and at least 1 ms of a timed budget, an empty budget keeps its default think time this way
+SearchBudget SearchClock::remaining_budget() const
+{
+    return SearchBudget{playout_limit, timed ? std::max<u_int>(1, remaining_ms()) : 0};
+}
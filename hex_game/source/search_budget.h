@@ -0,0 +1,49 @@
+#ifndef SEARCH_BUDGET_H
+#define SEARCH_BUDGET_H
+
+#include "utils.h"
+
+#include <chrono>
+
+// consts
+
+// iterations between two wall clock reads in per-playout search loops
+const u_int SEARCH_CLOCK_CHECK_INTERVAL = 64;
+// per-move latency target of a search started without a budget, the default playout count is cut short once it is
+// reached so every engine stays interactive up to 19x19 (measured by BM_DefaultBudgetMove in benchmarks/hot_paths.cpp)
+const u_int MOVE_LATENCY_TARGET_MS = 1000;
+// think time of a search started without a budget, leaves headroom under the target for workers to wind down
+const u_int DEFAULT_SEARCH_TIME_MS = 9 * MOVE_LATENCY_TARGET_MS / 10;
+
+// structs
+
+// limits of a single move search, a zero field means no limit
+// (when both are zero the engine falls back on its default playout count, within DEFAULT_SEARCH_TIME_MS)
+struct SearchBudget
+{
+    u_int playouts = 0;
+    u_int time_ms = 0;
+};
+
+// Tracks a search against its budget from the moment it is constructed
+class SearchClock
+{
+private:
+    std::chrono::steady_clock::time_point deadline;
+    bool timed;
+    u_int playout_limit;
+
+public:
+    SearchClock(SearchBudget, u_int);
+
+    bool timed_out() const { return timed && std::chrono::steady_clock::now() >= deadline; }
+    bool playouts_exhausted(u_int done) const { return playout_limit && done >= playout_limit; }
+    u_int remaining_playouts(u_int) const;
+    u_int remaining_ms() const;
+    SearchBudget remaining_budget() const;
+
+    // cheap check for loops counting single playouts, only reads the clock every SEARCH_CLOCK_CHECK_INTERVAL playouts
+    bool expired(u_int done) const { return playouts_exhausted(done) || (done % SEARCH_CLOCK_CHECK_INTERVAL == 0 && timed_out()); }
+};
+
+#endif
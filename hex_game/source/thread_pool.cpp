@@ -0,0 +1,50 @@
+#include "thread_pool.h"
+
+// number of workers used when no size is given, one per hardware thread
+u_int ThreadPool::default_size()
+{
+    u_int hw_threads = std::thread::hardware_concurrency();
+    return hw_threads ? hw_threads : 1;
+}
+
+// spins up the worker threads
+ThreadPool::ThreadPool(u_int worker_count)
+{
+    if (!worker_count)
+        worker_count = 1;
+
+    workers.reserve(worker_count);
+    for (u_int i = 0; i < worker_count; i++)
+        workers.emplace_back(&ThreadPool::worker_loop, this);
+}
+
+// drains the remaining tasks and joins the workers
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex);
+        stopping = true;
+    }
+    tasks_cv.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+// worker body, pops and runs tasks until the pool is stopped
+void ThreadPool::worker_loop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(tasks_mutex);
+            tasks_cv.wait(lock, [this]()
+                          { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
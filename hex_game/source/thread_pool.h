@@ -0,0 +1,53 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "utils.h"
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+// Persistent pool of worker threads consuming a shared task queue
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex tasks_mutex;
+    std::condition_variable tasks_cv;
+    bool stopping = false;
+
+    void worker_loop();
+
+public:
+    ThreadPool(u_int = default_size());
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ~ThreadPool();
+
+    static u_int default_size();
+    u_int get_size() { return workers.size(); }
+
+    // queues a task and returns a future holding its result
+    template <class F>
+    std::future<std::invoke_result_t<F>> submit(F &&task)
+    {
+        auto packaged = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(task));
+        std::future<std::invoke_result_t<F>> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(tasks_mutex);
+            tasks.emplace([packaged]()
+                          { (*packaged)(); });
+        }
+        tasks_cv.notify_one();
+        return result;
+    }
+};
+
+#endif
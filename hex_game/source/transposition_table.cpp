@@ -0,0 +1,56 @@
+#include "transposition_table.h"
+
+// allocates 2^bits zeroed slots
+TranspositionTable::TranspositionTable(u_int bits) : entries(new TTEntry[uint64_t(1) << bits]()), mask((uint64_t(1) << bits) - 1) {}
+
+// looks the position up in its bucket, returns false on a miss
+bool TranspositionTable::probe(uint64_t key, TTStats &stats)
+{
+    uint64_t slot = key & ~uint64_t(1) & mask;
+    for (uint64_t i = slot; i <= slot + 1; i++)
+    {
+        uint64_t data = entries[i].data.load(std::memory_order_relaxed);
+        if ((entries[i].checked_key.load(std::memory_order_relaxed) ^ data) == key && data)
+        {
+            stats = unpack(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+// writes the statistics of a position, over its own slot if present and over the less visited slot otherwise
+void TranspositionTable::store(uint64_t key, TTStats stats)
+{
+    uint64_t slot = key & ~uint64_t(1) & mask;
+    uint64_t target = slot;
+    uint32_t target_visits = UINT32_MAX;
+    for (uint64_t i = slot; i <= slot + 1; i++)
+    {
+        uint64_t data = entries[i].data.load(std::memory_order_relaxed);
+        if ((entries[i].checked_key.load(std::memory_order_relaxed) ^ data) == key)
+        {
+            target = i;
+            break;
+        }
+        if (unpack(data).visits < target_visits)
+        {
+            target = i;
+            target_visits = unpack(data).visits;
+        }
+    }
+
+    uint64_t data = pack(stats);
+    entries[target].data.store(data, std::memory_order_relaxed);
+    entries[target].checked_key.store(key ^ data, std::memory_order_relaxed);
+}
+
+// forgets every stored position
+void TranspositionTable::clear()
+{
+    for (uint64_t i = 0; i <= mask; i++)
+    {
+        entries[i].data.store(0, std::memory_order_relaxed);
+        entries[i].checked_key.store(0, std::memory_order_relaxed);
+    }
+}
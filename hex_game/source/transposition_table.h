@@ -0,0 +1,49 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include "utils.h"
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+// consts
+
+const u_int TT_DEFAULT_BITS = 18;
+
+// structs
+
+// search statistics of a position, wins are counted for the player who made the last move
+struct TTStats
+{
+    uint32_t visits;
+    uint32_t wins;
+};
+
+// table slot, the key is stored xor-ed with the data so a torn concurrent write reads back as a miss
+struct TTEntry
+{
+    std::atomic<uint64_t> checked_key;
+    std::atomic<uint64_t> data;
+};
+
+// Fixed size lock-free transposition table keyed by zobrist hash
+// (two slot buckets, a new position replaces the less visited slot)
+class TranspositionTable
+{
+private:
+    std::unique_ptr<TTEntry[]> entries;
+    uint64_t mask;
+
+    static uint64_t pack(TTStats stats) { return (static_cast<uint64_t>(stats.visits) << 32) | stats.wins; }
+    static TTStats unpack(uint64_t data) { return TTStats{static_cast<uint32_t>(data >> 32), static_cast<uint32_t>(data)}; }
+
+public:
+    TranspositionTable(u_int = TT_DEFAULT_BITS);
+
+    bool probe(uint64_t, TTStats &);
+    void store(uint64_t, TTStats);
+    void clear();
+};
+
+#endif
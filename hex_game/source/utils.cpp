@@ -1,5 +1,6 @@
 #include "utils.h"
 #include "player.h"
+#include "search_budget.h"
 
 #include <string>
 #include <iostream>
@@ -70,7 +71,7 @@ std::string gen_player_option(PLAYER_ID p_id)
 }
 
 // queries if the player wants to play against human or ai
-void query_player_params(bool &ai_switch, bool &colour_switch)
+void query_player_params(bool &ai_switch, bool &colour_switch, AI_ENGINE &engine)
 {
     std::string p1_option, p2_option;
     p1_option = gen_player_option(PLAYER_ID::P1);
@@ -80,20 +81,36 @@ void query_player_params(bool &ai_switch, bool &colour_switch)
         "Play against Human[0] or AI[1]? ",
         "Invalid option, please choose Human[0] or AI[1]: ");
 
-    if (ai_switch)
-        colour_switch = sanitise_input_with_cast<bool, int>(
-            "Choose your colour " + p1_option + " or " + p2_option + ": ",
-            "Invalid option, please choose " + p1_option + " or " + p2_option + ": ",
-            [](int &val) -> bool
-            {val-=1; return val == 0 || val == 1; });
+    if (!ai_switch)
+        return;
+
+    colour_switch = sanitise_input_with_cast<bool, int>(
+        "Choose your colour " + p1_option + " or " + p2_option + ": ",
+        "Invalid option, please choose " + p1_option + " or " + p2_option + ": ",
+        [](int &val) -> bool
+        {val-=1; return val == 0 || val == 1; });
+
+    engine = sanitise_input_with_cast<AI_ENGINE, int>(
+        "Choose the AI engine Monte Carlo[0], MCTS[1], root parallel MCTS[2], tree parallel MCTS[3] or resistance[4]: ",
+        "Invalid option, please choose Monte Carlo[0], MCTS[1], root parallel MCTS[2], tree parallel MCTS[3] or resistance[4]: ",
+        [](int &val) -> bool
+        { return val >= 0 && val <= 4; });
+}
+
+// queries the ai think time per move
+void query_search_params(u_int &time_ms)
+{
+    time_ms = sanitise_input<u_int>(
+        "Enter the AI think time per move in milliseconds (0 for the default playout count, within " + std::to_string(DEFAULT_SEARCH_TIME_MS) + " ms): ",
+        "Invalid think time given, please enter a whole number of milliseconds: ");
 }
 
 // queries board size
 void query_board_params(u_int &board_size)
 {
     board_size = sanitise_input<u_int>(
-        "Enter board size between [5 - 11]: ",
-        "Invalid board size given, please choose a value between [5 - 11]: ",
+        "Enter board size between [5 - 19]: ",
+        "Invalid board size given, please choose a value between [5 - 19]: ",
         [](u_int &val) -> bool
-        { return val > 4 && val < 12; });
+        { return val > 4 && val <= MAX_BOARD_SIZE; });
 }
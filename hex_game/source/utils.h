@@ -6,6 +6,7 @@
 #include <string>
 #include <iostream>
 #include <atomic>
+#include <cstdint>
 
 // Errors
 #define UNDEFINED_BEHAVIOUR_ERROR std::runtime_error("Undefined Behaviour!")
@@ -19,17 +20,22 @@
 #define WHITE "\033[37m" /* White */
 
 // escape codes from: https://gist.github.com/fnky/458719343aabd01cfb17a3a4f7296797
-#define ERASE_LINE "\x1b[2K"  /* Erases entire line */
-#define MOVE_UP_ONE "\x1b[1A" /* Moves cursor up 1 line */
+#define ERASE_LINE "\x1b[2K"          /* Erases entire line */
+#define MOVE_UP_ONE "\x1b[1A"         /* Moves cursor up 1 line */
+#define CURSOR_HOME "\x1b[H"          /* Moves cursor to the top left corner */
+#define ERASE_SCREEN "\x1b[2J"        /* Erases entire screen */
+#define ERASE_TO_SCREEN_END "\x1b[J"  /* Erases from the cursor to the end of the screen */
 
 // consts
 
 const int ALPHABET_SIZE = 26;
 const int ASCII_ALPHABET_START = 65;
+const u_int MAX_BOARD_SIZE = 19;
+const u_int MAX_BOARD_CELLS = MAX_BOARD_SIZE * MAX_BOARD_SIZE;
 
 // enums
 
-enum class ID_ENUM
+enum class ID_ENUM : uint8_t
 {
     NOT_SET,
     P1,
@@ -42,6 +48,15 @@ enum class REAL_VIRTUAL
     Virtual,
 };
 
+enum class AI_ENGINE
+{
+    MonteCarlo,
+    MCTS,
+    MCTSRootParallel,
+    MCTSTreeParallel,
+    Resistance, // one ply search on the resistance evaluator, instant but weaker than the searches
+};
+
 // Function definitions
 
 std::string make_string_idx_from_int_idx(int, std::string = "");
@@ -50,9 +65,22 @@ void print_game_intro();
 void print_win_state(ID_ENUM);
 void wait_for_enter_press();
 void clear_lines(u_int);
-void query_player_params(bool &, bool &);
+void query_player_params(bool &, bool &, AI_ENGINE &);
+void query_search_params(u_int &);
 void query_board_params(u_int &);
 
+// returns the opposing player
+inline ID_ENUM opponent_of(ID_ENUM p_id)
+{
+    return (p_id == ID_ENUM::P1) ? ID_ENUM::P2 : ID_ENUM::P1;
+}
+
+// index of a player in arrays holding one entry per player, P1 then P2
+inline u_int player_slot(ID_ENUM p_id)
+{
+    return (p_id == ID_ENUM::P1) ? 0 : 1;
+}
+
 // Template implementations
 // (Note: templates cannot have their definition and implementation separated: https://isocpp.org/wiki/faq/templates#templates-defn-vs-decl)
 
@@ -138,12 +166,12 @@ struct atomwrapper
     }
     atomwrapper &operator+=(T other)
     {
-        _a.store(_a.load() + other);
+        _a.fetch_add(other);
         return *this;
     }
     atomwrapper &operator-=(T other)
     {
-        _a.store(_a.load() - other);
+        _a.fetch_sub(other);
         return *this;
     }
     operator T()
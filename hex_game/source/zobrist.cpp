@@ -0,0 +1,35 @@
+#include "zobrist.h"
+#include "rng.h"
+
+#include <array>
+
+// consts
+
+// fixed seed so hashes are stable across runs
+const uint64_t ZOBRIST_SEED = 0x5eed0f4e7a8b9c1d;
+
+// returns the random key of a stone of the given player on the given flat cell index
+uint64_t zobrist_key(u_int idx, VIRTUAL_PIECE p_id)
+{
+    static const std::array<std::array<uint64_t, 2>, MAX_BOARD_CELLS> keys = []()
+    {
+        std::array<std::array<uint64_t, 2>, MAX_BOARD_CELLS> keys;
+        uint64_t seed = ZOBRIST_SEED;
+        for (auto &cell_keys : keys)
+            for (auto &key : cell_keys)
+                key = splitmix64(seed);
+        return keys;
+    }();
+
+    return keys[idx][p_id == VIRTUAL_PIECE::P1 ? 0 : 1];
+}
+
+// hashes a whole board from scratch, boards keep theirs up to date incrementally in update_board instead
+uint64_t zobrist_hash(const FlatBoard &board)
+{
+    uint64_t hash = 0;
+    for (u_int i = 0; i < board.cell_count(); i++)
+        if (board[i] != VIRTUAL_PIECE::NOT_SET)
+            hash ^= zobrist_key(i, board[i]);
+    return hash;
+}
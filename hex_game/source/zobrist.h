@@ -0,0 +1,16 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "utils.h"
+#include "flat_board.h"
+
+#include <cstdint>
+
+#define VIRTUAL_PIECE ID_ENUM
+
+// Function definitions
+
+uint64_t zobrist_key(u_int, VIRTUAL_PIECE);
+uint64_t zobrist_hash(const FlatBoard &);
+
+#endif
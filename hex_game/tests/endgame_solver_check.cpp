@@ -0,0 +1,100 @@
+/*
+Name: Endgame solver brute-force check
+Author: Alex Stet
+
+Compares EndgameSolver against an exhaustive minimax on seeded random positions of 3x3, 4x4 and 5x5 boards
+(456 positions that neither player has already won). For every position the solver must not give up, must
+agree with the brute force on whether the player to move wins, must return a move that keeps the win when it
+reports one, and must give the same result again from its warm transposition table.
+Exits non-zero on any mismatch.
+
+build (from the hex_game directory):
+    cmake -S . -B build && cmake --build build --target endgame_solver_check
+
+usage:
+    ./build/endgame_solver_check
+*/
+
+#include "utils.h"
+#include "flat_board.h"
+#include "bitboard.h"
+#include "endgame_solver.h"
+#include "rng.h"
+
+#include <iostream>
+
+// checks if the player has connected their edges on the given board
+bool player_connected(const FlatBoard &board, VIRTUAL_PIECE p_id)
+{
+    return HexBitBoard(board).player_connected(p_id);
+}
+
+// checks by exhaustive search if the player to move wins the given position
+bool brute_force_wins(FlatBoard &board, VIRTUAL_PIECE p_id)
+{
+    for (u_int i = 0; i < board.cell_count(); i++)
+        if (board[i] == VIRTUAL_PIECE::NOT_SET)
+        {
+            board[i] = p_id;
+            bool wins = player_connected(board, p_id) || !brute_force_wins(board, opponent_of(p_id));
+            board[i] = VIRTUAL_PIECE::NOT_SET;
+            if (wins)
+                return true;
+        }
+    return false;
+}
+
+// returns the number of mismatches between the solver and the brute force on the given position
+int check_position(FlatBoard &board, VIRTUAL_PIECE p_id)
+{
+    EndgameSolver solver(board.get_size());
+    u_int move;
+    SOLVER_RESULT result = solver.solve(board, p_id, move);
+    bool wins = brute_force_wins(board, p_id);
+    if (result == SOLVER_RESULT::Unknown || (result == SOLVER_RESULT::Win) != wins)
+        return 1;
+
+    if (wins)
+    {
+        board[move] = p_id;
+        bool keeps_win = player_connected(board, p_id) || !brute_force_wins(board, opponent_of(p_id));
+        board[move] = VIRTUAL_PIECE::NOT_SET;
+        if (!keeps_win)
+            return 1;
+    }
+
+    u_int warm_move;
+    return solver.solve(board, p_id, warm_move) != result;
+}
+
+int main()
+{
+    int checked = 0, mismatches = 0;
+    for (u_int size : {3u, 4u, 5u})
+        for (int seed = 0; seed < (size == 5 ? 60 : 200); seed++)
+        {
+            Xoshiro256 rng(seed * 7 + size);
+            FlatBoard board(size);
+
+            // alternating stones on random cells, few on 3x3 and enough on 5x5 for the brute force to finish
+            u_int stones = size == 3 ? rng() % 4 : size == 4 ? 3 + rng() % 6 : 12 + rng() % 4;
+            for (u_int placed = 0; placed < stones;)
+            {
+                u_int idx = rng() % (size * size);
+                if (board[idx] == VIRTUAL_PIECE::NOT_SET)
+                    board[idx] = placed++ % 2 ? VIRTUAL_PIECE::P2 : VIRTUAL_PIECE::P1;
+            }
+            if (player_connected(board, VIRTUAL_PIECE::P1) || player_connected(board, VIRTUAL_PIECE::P2))
+                continue;
+
+            checked++;
+            if (check_position(board, stones % 2 ? VIRTUAL_PIECE::P2 : VIRTUAL_PIECE::P1))
+            {
+                mismatches++;
+                std::cout << "mismatch on " << size << "x" << size << " seed " << seed << "\n";
+            }
+        }
+
+    std::cout << "checked " << checked << " positions, " << mismatches << " mismatches\n";
+    return (mismatches || !checked) ? 1 : 0;
+}
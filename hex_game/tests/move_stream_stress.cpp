@@ -0,0 +1,108 @@
+/*
+Name: Move stream stress test
+Author: Alex Stet
+
+Publishes STRESS_MOVES moves into one MoveStream while STRESS_READERS readers follow it from their own threads,
+the last one deliberately slow so the producer laps it. Every move carries its sequence number (row and column
+bytes) and the piece of its parity, so each reader checks that it sees the moves in order with no duplicate
+and that its received plus dropped moves account for every published one. The slow reader must have been lapped,
+so the skip over overwritten moves is exercised on every run.
+Exits non-zero if any reader fails. Build with -fsanitize=thread to check the stream for races too.
+
+build (from the hex_game directory):
+    cmake -S . -B build && cmake --build build --target move_stream_stress
+
+usage:
+    ./build/move_stream_stress
+*/
+
+#include "utils.h"
+#include "move_stream.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// consts
+
+const uint64_t STRESS_MOVES = 2000000;
+const u_int STRESS_READERS = 4;
+const auto STRESS_SLOW_READER_DELAY = std::chrono::microseconds(50);
+// moves between two yields of the producer, less than the stream capacity so the readers interleave with it
+// even on a single core
+const u_int STRESS_YIELD_INTERVAL = MOVE_STREAM_CAPACITY / 2;
+
+// structs
+
+struct ReaderResult
+{
+    uint64_t received = 0;
+    uint64_t dropped = 0;
+    uint64_t out_of_order = 0;
+};
+
+// the move published as the given sequence number, its low 16 bits in row and column
+Move stress_move(uint64_t sequence)
+{
+    return Move{static_cast<uint8_t>(sequence >> 8), static_cast<uint8_t>(sequence), sequence % 2 ? VIRTUAL_PIECE::P2 : VIRTUAL_PIECE::P1};
+}
+
+// follows the stream until the producer is done and every move it can still reach is read
+void follow(const MoveStream &stream, const std::atomic<bool> &publishing_done, bool slow, ReaderResult &result)
+{
+    MoveStreamReader reader(stream);
+    Move move;
+
+    bool last_pass = false;
+    while (!last_pass)
+    {
+        last_pass = publishing_done.load();
+        while (reader.poll(move))
+        {
+            // the move just read is the one published after every move received or dropped before it
+            Move expected = stress_move(result.received + reader.get_dropped());
+            if (move.row != expected.row || move.col != expected.col || move.piece != expected.piece)
+                result.out_of_order++;
+            result.received++;
+            if (slow)
+                std::this_thread::sleep_for(STRESS_SLOW_READER_DELAY);
+        }
+    }
+    result.dropped = reader.get_dropped();
+}
+
+int main()
+{
+    MoveStream stream;
+    std::atomic<bool> publishing_done(false);
+    std::vector<ReaderResult> results(STRESS_READERS);
+    std::vector<std::thread> readers;
+    for (u_int i = 0; i < STRESS_READERS; i++)
+        readers.emplace_back(follow, std::cref(stream), std::cref(publishing_done), i == STRESS_READERS - 1, std::ref(results[i]));
+
+    for (uint64_t sequence = 0; sequence < STRESS_MOVES; sequence++)
+    {
+        stream.update(stress_move(sequence));
+        if (sequence % STRESS_YIELD_INTERVAL == 0)
+            std::this_thread::yield();
+    }
+    publishing_done = true;
+    for (auto &reader : readers)
+        reader.join();
+
+    int failures = 0;
+    for (u_int i = 0; i < STRESS_READERS; i++)
+    {
+        const ReaderResult &result = results[i];
+        bool slow = i == STRESS_READERS - 1;
+        std::cout << "reader " << i << (slow ? " (slow)" : "") << ": received " << result.received << ", dropped " << result.dropped
+                  << ", out of order " << result.out_of_order << "\n";
+
+        // a fast reader may be lapped on a busy machine too, it must only never lose track of a move
+        if (result.out_of_order || result.received + result.dropped != STRESS_MOVES || (slow && !result.dropped))
+            failures++;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,348 @@
+/*
+Name: Hex Game headless tournament runner
+Author: Alex Stet
+Date: 05-08-2025 (dd-mm-yyyy)
+
+Note:
+    Plays AI vs AI games in parallel without any terminal interaction and writes one record per game
+    (result, move list and per-move timings) as JSON lines, or as CSV when the output file ends in .csv.
+    Engines alternate colours, engine a plays P1 in even numbered games.
+    Runs are reproducible for a given seed with --jobs 1 --threads 1 and a playout budget.
+    Every game publishes its moves into a move stream, --spectate follows all of them live from a separate
+    thread and prints each move to stderr, the games never wait on it.
+
+gcc compile instructions:
+    g++ -pthread -O2 -o tournament -I ./source/ tournament.cpp source/*.cpp
+
+usage:
+    tournament [--games N] [--jobs N] [--threads N] [--size N] [--engine-a NAME] [--engine-b NAME]
+               [--policy-a NAME] [--policy-b NAME] [--playouts N] [--time-ms N] [--seed N] [--ponder] [--spectate]
+               [--output FILE]
+    engine names: montecarlo, mcts, mcts-root, mcts-tree, resistance
+    playout policy names: uniform, bridge
+*/
+
+#include "utils.h"
+#include "hex_board.h"
+#include "player.h"
+#include "thread_pool.h"
+#include "rng.h"
+#include "move_stream.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// consts
+
+const std::map<std::string, AI_ENGINE> ENGINE_NAMES =
+    {
+        {"montecarlo", AI_ENGINE::MonteCarlo},
+        {"mcts", AI_ENGINE::MCTS},
+        {"mcts-root", AI_ENGINE::MCTSRootParallel},
+        {"mcts-tree", AI_ENGINE::MCTSTreeParallel},
+        {"resistance", AI_ENGINE::Resistance},
+};
+
+const std::map<std::string, PLAYOUT_POLICY> POLICY_NAMES =
+    {
+        {"uniform", PLAYOUT_POLICY::Uniform},
+        {"bridge", PLAYOUT_POLICY::Bridge},
+};
+
+// structs
+
+struct TournamentConfig
+{
+    u_int games = 10;
+    u_int jobs = ThreadPool::default_size();
+    u_int threads = 1; // search threads of each player
+    u_int size = 7;
+    std::string engine_a = "mcts";
+    std::string engine_b = "montecarlo";
+    std::string policy_a = "uniform";
+    std::string policy_b = "uniform";
+    SearchBudget budget;
+    uint64_t seed = 1;
+    bool ponder = false;
+    bool spectate = false;
+    std::string output = "tournament.jsonl";
+};
+
+struct GameRecord
+{
+    u_int game;
+    std::string p1_engine;
+    std::string p2_engine;
+    std::string p1_policy;
+    std::string p2_policy;
+    u_int winner;
+    std::vector<std::string> moves;
+    std::vector<double> move_ms;
+    double total_ms;
+};
+
+// raises games_done and joins the spectator thread when main returns, whichever way it leaves
+struct SpectatorJoin
+{
+    std::atomic<bool> &games_done;
+    std::thread &spectator;
+
+    ~SpectatorJoin()
+    {
+        games_done = true;
+        if (spectator.joinable())
+            spectator.join();
+    }
+};
+
+// prints the command line options
+void print_usage()
+{
+    std::cerr << "usage: tournament [--games N] [--jobs N] [--threads N] [--size N] [--engine-a NAME] [--engine-b NAME]\n"
+              << "                  [--policy-a NAME] [--policy-b NAME] [--playouts N] [--time-ms N] [--seed N] [--ponder]\n"
+              << "                  [--spectate] [--output FILE]\n"
+              << "engine names: montecarlo, mcts, mcts-root, mcts-tree, resistance\n"
+              << "playout policy names: uniform, bridge\n";
+}
+
+// reads the command line into the config, returns false on any invalid option
+bool parse_args(int argc, char **argv, TournamentConfig &config)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if (option == "--ponder" || option == "--spectate")
+        {
+            (option == "--ponder" ? config.ponder : config.spectate) = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return false;
+
+        std::string value = argv[++i];
+        try
+        {
+            if (option == "--games")
+                config.games = std::stoul(value);
+            else if (option == "--jobs")
+                config.jobs = std::stoul(value);
+            else if (option == "--threads")
+                config.threads = std::stoul(value);
+            else if (option == "--size")
+                config.size = std::stoul(value);
+            else if (option == "--engine-a")
+                config.engine_a = value;
+            else if (option == "--engine-b")
+                config.engine_b = value;
+            else if (option == "--policy-a")
+                config.policy_a = value;
+            else if (option == "--policy-b")
+                config.policy_b = value;
+            else if (option == "--playouts")
+                config.budget.playouts = std::stoul(value);
+            else if (option == "--time-ms")
+                config.budget.time_ms = std::stoul(value);
+            else if (option == "--seed")
+                config.seed = std::stoull(value);
+            else if (option == "--output")
+                config.output = value;
+            else
+                return false;
+        }
+        catch (const std::logic_error &)
+        {
+            return false;
+        }
+    }
+
+    return config.games && config.jobs && config.threads && config.size > 1 && config.size <= MAX_BOARD_SIZE &&
+           ENGINE_NAMES.count(config.engine_a) && ENGINE_NAMES.count(config.engine_b) &&
+           POLICY_NAMES.count(config.policy_a) && POLICY_NAMES.count(config.policy_b);
+}
+
+// returns the name of the cell a move was played on, i.e. C4
+std::string move_name(const Move &move)
+{
+    return make_string_idx_from_int_idx(move.col) + std::to_string(move.row + 1);
+}
+
+/*
+ * Plays one game to the end, every player searches on a virtual board of its own so engines never share trees,
+ * every board observes both players to keep its groups and trees in step with the game.
+ * The moves are published into the game's move stream, the record is read back from it.
+ * The players and boards are owned here and go before the real board on every path, a game that throws included,
+ * so a failed game stops its searches and pools before the next one starts.
+ */
+GameRecord play_game(const TournamentConfig &config, u_int game, MoveStream &move_stream)
+{
+    GameRecord record{game, config.engine_a, config.engine_b, config.policy_a, config.policy_b, 0, {}, {}, 0.0};
+    if (game % 2)
+    {
+        std::swap(record.p1_engine, record.p2_engine);
+        std::swap(record.p1_policy, record.p2_policy);
+    }
+
+    std::unique_ptr<HexBoardABC> real_board(HexBoardFactory::make(config.size));
+    std::unique_ptr<HexBoardABC> virtual_boards[2] = {
+        std::unique_ptr<HexBoardABC>(HexBoardFactory::make(real_board.get(), config.threads, POLICY_NAMES.at(record.p1_policy))),
+        std::unique_ptr<HexBoardABC>(HexBoardFactory::make(real_board.get(), config.threads, POLICY_NAMES.at(record.p2_policy)))};
+    std::unique_ptr<HexPlayerABC> players[2] = {
+        std::unique_ptr<HexPlayerABC>(HexPlayerFactory::make(PLAYER_ID::P1, true, ENGINE_NAMES.at(record.p1_engine), config.budget, config.ponder)),
+        std::unique_ptr<HexPlayerABC>(HexPlayerFactory::make(PLAYER_ID::P2, true, ENGINE_NAMES.at(record.p2_engine), config.budget, config.ponder))};
+    for (auto &player : players)
+    {
+        player->attach(real_board.get());
+        for (auto &board : virtual_boards)
+            player->attach(board.get());
+        player->attach(&move_stream);
+    }
+
+    u_int turn = 0;
+    Move move;
+    MoveStreamReader move_reader(move_stream);
+    auto game_start = std::chrono::steady_clock::now();
+    while (!real_board->get_win_state())
+    {
+        HexBoardABC *board = virtual_boards[turn].get();
+        auto move_start = std::chrono::steady_clock::now();
+        players[turn]->make_move(board);
+        std::chrono::duration<double, std::milli> move_time = std::chrono::steady_clock::now() - move_start;
+
+        if (!move_reader.poll(move))
+            throw UNDEFINED_BEHAVIOUR_ERROR;
+        record.moves.push_back(move_name(move));
+        record.move_ms.push_back(move_time.count());
+        turn = !turn;
+    }
+    std::chrono::duration<double, std::milli> game_time = std::chrono::steady_clock::now() - game_start;
+    record.total_ms = game_time.count();
+    record.winner = turn ? 1 : 2;
+
+    return record;
+}
+
+// writes a game record as a single json line
+void write_jsonl(std::ostream &out, const TournamentConfig &config, const GameRecord &record)
+{
+    out << "{\"game\":" << record.game << ",\"seed\":" << config.seed << ",\"size\":" << config.size
+        << ",\"p1\":\"" << record.p1_engine << "\",\"p2\":\"" << record.p2_engine << "\""
+        << ",\"p1_policy\":\"" << record.p1_policy << "\",\"p2_policy\":\"" << record.p2_policy << "\",\"winner\":" << record.winner
+        << ",\"winner_engine\":\"" << (record.winner == 1 ? record.p1_engine : record.p2_engine) << "\""
+        << ",\"move_count\":" << record.moves.size() << ",\"total_ms\":" << record.total_ms << ",\"moves\":[";
+    for (u_int i = 0; i < record.moves.size(); i++)
+        out << (i ? "," : "") << "\"" << record.moves[i] << "\"";
+    out << "],\"move_ms\":[";
+    for (u_int i = 0; i < record.move_ms.size(); i++)
+        out << (i ? "," : "") << record.move_ms[i];
+    out << "]}\n";
+}
+
+// writes a game record as a csv row, the move and timing lists are space separated
+void write_csv(std::ostream &out, const TournamentConfig &config, const GameRecord &record)
+{
+    out << record.game << "," << config.seed << "," << config.size << "," << record.p1_engine << "," << record.p2_engine << ","
+        << record.p1_policy << "," << record.p2_policy << "," << record.winner << "," << (record.winner == 1 ? record.p1_engine : record.p2_engine) << ","
+        << record.moves.size() << "," << record.total_ms << ",";
+    for (u_int i = 0; i < record.moves.size(); i++)
+        out << (i ? " " : "") << record.moves[i];
+    out << ",";
+    for (u_int i = 0; i < record.move_ms.size(); i++)
+        out << (i ? " " : "") << record.move_ms[i];
+    out << "\n";
+}
+
+int main(int argc, char **argv)
+{
+    TournamentConfig config;
+    if (!parse_args(argc, argv, config))
+    {
+        print_usage();
+        return 1;
+    }
+
+    std::ofstream out(config.output);
+    if (!out)
+    {
+        std::cerr << "cannot open " << config.output << "\n";
+        return 1;
+    }
+    bool csv = config.output.size() >= 4 && config.output.compare(config.output.size() - 4, 4, ".csv") == 0;
+    out << std::fixed << std::setprecision(3);
+    if (csv)
+        out << "game,seed,size,p1,p2,p1_policy,p2_policy,winner,winner_engine,move_count,total_ms,moves,move_ms\n";
+
+    set_master_seed(config.seed);
+
+    // one stream per game, the spectator reads them all while the games write to them
+    std::unique_ptr<MoveStream[]> move_streams(new MoveStream[config.games]);
+    std::atomic<bool> games_done(false);
+    std::thread spectator;
+    if (config.spectate)
+        spectator = std::thread([&config, &move_streams, &games_done]()
+                                {
+                                    std::vector<MoveStreamReader> readers;
+                                    for (u_int game = 0; game < config.games; game++)
+                                        readers.emplace_back(move_streams[game]);
+
+                                    bool last_pass = false;
+                                    while (!last_pass)
+                                    {
+                                        last_pass = games_done.load();
+                                        Move move;
+                                        for (u_int game = 0; game < config.games; game++)
+                                            while (readers[game].poll(move))
+                                                std::cerr << "game " << game << ": " << (move.piece == PLAYER_ID::P1 ? "P1 " : "P2 ") << move_name(move) << "\n";
+                                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                                    } });
+    SpectatorJoin spectator_join{games_done, spectator};
+
+    ThreadPool game_pool(config.jobs);
+    std::vector<std::future<GameRecord>> results;
+    for (u_int game = 0; game < config.games; game++)
+        results.push_back(game_pool.submit([&config, &move_streams, game]()
+                                           { return play_game(config, game, move_streams[game]); }));
+
+    // a game that fails is reported and left out, the others still count
+    u_int engine_a_wins = 0, total_moves = 0, games_played = 0;
+    double total_move_ms = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (u_int game = 0; game < config.games; game++)
+    {
+        GameRecord record;
+        try
+        {
+            record = results[game].get();
+        }
+        catch (const std::exception &error)
+        {
+            std::cerr << "game " << game << " failed: " << error.what() << "\n";
+            continue;
+        }
+        games_played++;
+        csv ? write_csv(out, config, record) : write_jsonl(out, config, record);
+        out.flush();
+
+        // engine a plays P1 in even numbered games
+        engine_a_wins += (record.winner == 1) == (record.game % 2 == 0);
+        total_moves += record.moves.size();
+        for (double ms : record.move_ms)
+            total_move_ms += ms;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << config.engine_a << " (" << config.policy_a << ") vs " << config.engine_b << " (" << config.policy_b << ") on " << config.size << "x" << config.size << ": "
+              << engine_a_wins << "-" << games_played - engine_a_wins << " over " << games_played << " games\n"
+              << "mean move time " << total_move_ms / std::max(1u, total_moves) << " ms, "
+              << games_played / elapsed.count() << " games/s\n";
+
+    return games_played == config.games ? 0 : 1;
+}